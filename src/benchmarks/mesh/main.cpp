@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <core/jobs.hpp>
+#include <core/mesh.hpp>
+
+// Scaling of the mesh-generation workload from one core to all of them.
+//
+//     bench_mesh [divisions] [repetitions] [max threads]
+
+static double medianMilliseconds(int repetitions, const std::function<void()> &work)
+{
+    std::vector<double> samples;
+    for (int repetition_n = 0; repetition_n < repetitions; repetition_n++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        work();
+        auto end = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+int main(int argc, char **argv)
+{
+    const std::size_t divisions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1 << 20;
+    const int repetitions = argc > 2 ? std::atoi(argv[2]) : 7;
+    const unsigned int maxThreads = argc > 3 ? std::atoi(argv[3]) : std::max(std::thread::hardware_concurrency(), 1u);
+
+    // Independent circles built as fan -> weld task chains.
+    const std::size_t circleCount = 16;
+    const std::size_t circleDivisions = std::max<std::size_t>(divisions / circleCount, 3);
+
+    std::printf("divisions=%zu repetitions=%d\n", divisions, repetitions);
+    std::printf("%8s %12s %12s %12s %12s %10s\n", "threads", "fan ms", "indexed ms", "weld ms", "graph ms", "speedup");
+
+    const std::vector<float> soup = core::mesh::circleFan(divisions).vertices;
+    double baseline = 0;
+
+    for (unsigned int threads = 1; threads <= maxThreads; threads++)
+    {
+        // The calling thread helps, so N cores means N - 1 workers.
+        core::JobSystem jobs(threads - 1);
+
+        double fan = medianMilliseconds(repetitions, [&] { core::mesh::circleFan(divisions, jobs); });
+        double indexed = medianMilliseconds(repetitions, [&] { core::mesh::circleIndexed(divisions, jobs); });
+        double weld = medianMilliseconds(repetitions, [&] { core::mesh::weld(soup, 1e-6f, jobs); });
+        double graph = medianMilliseconds(
+            repetitions,
+            [&]
+            {
+                std::vector<core::mesh::Mesh> fans(circleCount);
+                std::vector<core::mesh::Mesh> welded(circleCount);
+                std::vector<core::TaskHandle> tails;
+                for (std::size_t circle_n = 0; circle_n < circleCount; circle_n++)
+                {
+                    core::TaskHandle generate = jobs.createTask(
+                        [&, circle_n] { fans[circle_n] = core::mesh::circleFan(circleDivisions, jobs); });
+                    core::TaskHandle merge = jobs.createTask(
+                        [&, circle_n] { welded[circle_n] = core::mesh::weld(fans[circle_n].vertices, 1e-6f, jobs); });
+                    jobs.addDependency(merge, generate);
+                    jobs.submit(merge);
+                    jobs.submit(generate);
+                    tails.push_back(merge);
+                }
+                for (const core::TaskHandle &tail : tails)
+                {
+                    jobs.wait(tail);
+                }
+            });
+
+        double total = fan + indexed + weld + graph;
+        if (threads == 1)
+        {
+            baseline = total;
+        }
+        std::printf("%8u %12.3f %12.3f %12.3f %12.3f %9.2fx\n", threads, fan, indexed, weld, graph, baseline / total);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <core/application.hpp>
+#include <core/gl.hpp>
+#include <core/log.hpp>
+#include <core/shader.hpp>
+
+#include <shaders/basic_vertex.generated.hpp>
+#include <shaders/basic_fragment.generated.hpp>
+
+// Compile + link time of every matching shader variant pair, from GLSL
+// source and from the embedded SPIR-V modules.
+//
+//     bench_shaders [--repetitions <n>] [application options]
+//
+// Headless by default (see core::parseArguments). Drivers cache compiled
+// shaders in memory and on disk, so only the first repetition is cold; for
+// cold numbers on every run disable the driver cache
+// (MESA_SHADER_CACHE_DISABLE=true, __GL_SHADER_DISK_CACHE=0).
+
+int main(int argc, char **argv)
+{
+    int repetitions = 7;
+
+    // Everything not recognised here goes to the application.
+    std::vector<char *> applicationArguments = {argv[0]};
+    for (int argument_n = 1; argument_n < argc; argument_n++)
+    {
+        if (std::strcmp(argv[argument_n], "--repetitions") == 0 && argument_n + 1 < argc)
+        {
+            repetitions = std::max(std::atoi(argv[++argument_n]), 1);
+        }
+        else
+        {
+            applicationArguments.push_back(argv[argument_n]);
+        }
+    }
+
+    core::ApplicationConfig defaults;
+    defaults.headless = true;
+    defaults.title = "bench_shaders";
+    defaults.width = 64;
+    defaults.height = 64;
+    const core::ApplicationConfig config = core::parseArguments(static_cast<int>(applicationArguments.size()), applicationArguments.data(), defaults);
+
+    // Keeps stdout clean for the report.
+    core::log::threshold = core::log::Level::Warning;
+    core::Application application(config);
+    if (!application.valid())
+    {
+        return EXIT_FAILURE;
+    }
+
+    // Pairs whose interfaces match: both or neither pass the vertex color.
+    std::vector<std::pair<const EmbeddedShader *, const EmbeddedShader *>> pairs;
+    bool spirv = core::gl::extensions().spirv;
+    for (const EmbeddedShader &vertex : basic_vertex_variants)
+    {
+        for (const EmbeddedShader &fragment : basic_fragment_variants)
+        {
+            const bool vertexColor = vertex.features & basic_vertex_feature::VERTEX_COLOR;
+            if (vertexColor == static_cast<bool>(fragment.features & basic_fragment_feature::VERTEX_COLOR))
+            {
+                pairs.emplace_back(&vertex, &fragment);
+                spirv = spirv && vertex.spirv && fragment.spirv;
+            }
+        }
+    }
+
+    std::printf("GL %d.%d, %zu programs, repetitions=%d\n", GLVersion.major, GLVersion.minor, pairs.size(), repetitions);
+    std::printf("%8s %12s %12s %12s\n", "format", "cold ms", "median ms", "min ms");
+
+    for (core::ShaderFormat format : {core::ShaderFormat::Glsl, core::ShaderFormat::Spirv})
+    {
+        const char *name = format == core::ShaderFormat::Glsl ? "glsl" : "spir-v";
+        if (format == core::ShaderFormat::Spirv && !spirv)
+        {
+            std::printf("%8s %12s\n", name, core::gl::extensions().spirv ? "no modules (glslangValidator missing at build)" : "unsupported by context");
+            continue;
+        }
+
+        std::vector<double> samples;
+        for (int repetition_n = 0; repetition_n < repetitions; repetition_n++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (const auto &[vertex, fragment] : pairs)
+            {
+                core::PendingProgram pending(*vertex, *fragment, nullptr, format);
+                glDeleteProgram(pending.finish());
+            }
+            auto end = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+        }
+
+        const double cold = samples.front();
+        std::sort(samples.begin(), samples.end());
+        std::printf("%8s %12.3f %12.3f %12.3f\n", name, cold, samples[samples.size() / 2], samples.front());
+    }
+
+    return EXIT_SUCCESS;
+}
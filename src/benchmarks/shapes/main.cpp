@@ -0,0 +1,445 @@
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <core/application.hpp>
+#include <core/frame.hpp>
+#include <core/log.hpp>
+#include <core/mesh.hpp>
+#include <core/mesh_buffers.hpp>
+#include <core/pipeline_statistics.hpp>
+
+#include <shaders/basic_vertex.generated.hpp>
+#include <shaders/basic_fragment.generated.hpp>
+
+// Frame cost of every example's geometry over a sweep of segment and
+// instance counts, drawn through the same frame pipeline the examples use.
+// Each instance is its own draw with its own Transform block. The last
+// frame also runs pipeline statistics queries, so vertex shader runs per
+// triangle can be compared with the ACMR a 32-entry FIFO cache predicts.
+// Without ARB_pipeline_statistics_query shader runs and the measured ACMR
+// are null (empty in CSV).
+//
+//     bench_shapes [--segments 8,64,...] [--instances 1,16,...]
+//                  [--csv] [--output <file>] [application options]
+//
+// Headless by default (see core::parseArguments for --size, --frames).
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::uint64_t WarmupFrames = 10;
+    constexpr std::size_t CacheSize = 32;
+
+    struct Shape
+    {
+        const char *name;
+        core::mesh::Mesh (*generate)(std::size_t segments);
+        // False for shapes with a fixed vertex count.
+        bool segmented;
+    };
+
+    core::mesh::Mesh triangle(std::size_t)
+    {
+        return {{-0.5f, -0.5f, 0.0f, 0.5f, -0.5f, 0.0f, 0.0f, 0.5f, 0.0f}, {}};
+    }
+
+    core::mesh::Mesh square(std::size_t)
+    {
+        return {{.5f, .5f, .0f, .5f, -.5f, .0f, -.5f, -.5f, .0f, -.5f, .5f, .0f}, {0, 1, 3, 1, 2, 3}};
+    }
+
+    core::mesh::Mesh fan(std::size_t segments)
+    {
+        return core::mesh::circleFan(segments);
+    }
+
+    core::mesh::Mesh indexed(std::size_t segments)
+    {
+        return core::mesh::circleIndexed(segments);
+    }
+
+    const Shape Shapes[] = {
+        {"triangle", triangle, false},
+        {"square", square, false},
+        {"overlap_circle", fan, true},
+        {"optimized_circle", indexed, true}};
+
+    struct Result
+    {
+        std::string shape;
+        std::size_t segments;
+        std::size_t instances;
+        std::uint64_t frames;
+        double fps;
+        double cpu[3];
+        double gpu[3];
+        std::size_t vertices;
+        std::size_t drawCalls;
+        std::size_t uniformBytes;
+        std::size_t meshBytes;
+        // Per draw, from the last frame.
+        core::PipelineCounts statistics;
+        double measuredAcmr;
+        double theoreticalAcmr;
+    };
+
+    // Comma-separated positive counts; empty when any entry is not one.
+    std::vector<std::size_t> parseList(const char *text)
+    {
+        std::vector<std::size_t> values;
+        for (const char *cursor = text;; cursor++)
+        {
+            char *end;
+            const std::size_t value = std::isdigit(static_cast<unsigned char>(*cursor)) ? std::strtoull(cursor, &end, 10) : 0;
+            if (value == 0 || (*end != ',' && *end != '\0'))
+            {
+                return {};
+            }
+            values.push_back(value);
+            if (*end == '\0')
+            {
+                return values;
+            }
+            cursor = end;
+        }
+    }
+
+    // p50, p95 and p99 in milliseconds.
+    void percentiles(std::vector<double> samples, double (&out)[3])
+    {
+        if (samples.empty())
+        {
+            out[0] = out[1] = out[2] = 0;
+            return;
+        }
+        std::sort(samples.begin(), samples.end());
+        const double points[] = {.50, .95, .99};
+        for (int point_n = 0; point_n < 3; point_n++)
+        {
+            out[point_n] = samples[static_cast<std::size_t>(points[point_n] * (samples.size() - 1))];
+        }
+    }
+
+    Result measure(core::Application &application, const Shape &shape, std::size_t segments, std::size_t instances, std::uint64_t frames)
+    {
+        const core::mesh::Mesh mesh = shape.generate(segments);
+        core::MeshBuffers buffers(mesh);
+        const core::DrawCommand draw = buffers.draw();
+
+        // Instances on a grid covering clip space.
+        const std::size_t grid = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(instances))));
+        const float cell = 2.0f / grid;
+
+        const std::size_t depth = 2;
+        core::FramePipeline<core::FrameCommands> pipeline(
+            depth,
+            [&](core::FrameCommands &frame, std::uint64_t)
+            {
+                frame.clearColor = {.2f, .3f, .3f, 1.0f};
+                frame.uniformAlignment = application.uniforms().alignment();
+                frame.uniforms.clear();
+                frame.draws.clear();
+                for (std::size_t instance_n = 0; instance_n < instances; instance_n++)
+                {
+                    uniforms::Transform transform = {};
+                    transform.model[0][0] = cell * .45f;
+                    transform.model[1][1] = cell * .45f;
+                    transform.model[2][2] = 1.0f;
+                    transform.model[3][0] = -1.0f + cell * (instance_n % grid + .5f);
+                    transform.model[3][1] = -1.0f + cell * (instance_n / grid + .5f);
+                    transform.model[3][3] = 1.0f;
+
+                    core::DrawCommand command = draw;
+                    command.uniforms = frame.stage(uniforms::Transform::binding, transform);
+                    frame.draws.push_back(command);
+                }
+            });
+
+        // One timer query per pipeline slot: by the time a slot comes round
+        // again its fence has signalled, so reading the result never stalls.
+        std::vector<GLuint> queries(depth);
+        glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+
+        core::PipelineStatistics statistics;
+        std::vector<double> cpu;
+        std::vector<double> gpu;
+        std::size_t uniformBytes = 0;
+        Clock::time_point measuredStart = Clock::now();
+
+        const std::uint64_t total = frames + WarmupFrames;
+        for (std::uint64_t frame_n = 0; frame_n < total; frame_n++)
+        {
+            if (frame_n == WarmupFrames)
+            {
+                measuredStart = Clock::now();
+            }
+
+            const core::FrameCommands &frame = pipeline.beginFrame();
+            GLuint query = queries[frame_n % depth];
+            if (frame_n >= WarmupFrames + depth)
+            {
+                GLuint64 elapsed = 0;
+                glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+                gpu.push_back(elapsed / 1e6);
+            }
+
+            const bool last = frame_n + 1 == total;
+            const Clock::time_point start = Clock::now();
+            glBeginQuery(GL_TIME_ELAPSED, query);
+            if (last)
+            {
+                statistics.begin();
+            }
+            core::submit(frame, &application.uniforms());
+            if (last)
+            {
+                statistics.end();
+            }
+            glEndQuery(GL_TIME_ELAPSED);
+            if (application.glfwWindow())
+            {
+                glfwPollEvents();
+                glfwSwapBuffers(application.glfwWindow());
+            }
+            if (frame_n >= WarmupFrames)
+            {
+                cpu.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+            }
+            uniformBytes = frame.uniforms.size();
+            pipeline.endFrame();
+        }
+        glFinish();
+        const double seconds = std::chrono::duration<double>(Clock::now() - measuredStart).count();
+        glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+
+        core::PipelineCounts counts = statistics.read();
+        for (std::uint64_t *count : {
+                 &counts.verticesSubmitted,
+                 &counts.primitivesSubmitted,
+                 &counts.vertexShaderInvocations,
+                 &counts.primitives,
+                 &counts.fragmentShaderInvocations,
+                 &counts.samplesPassed})
+        {
+            *count /= instances;
+        }
+        const std::size_t triangles = static_cast<std::size_t>(draw.count) / 3;
+
+        Result result = {
+            shape.name,
+            segments,
+            instances,
+            frames,
+            frames / seconds,
+            {},
+            {},
+            static_cast<std::size_t>(draw.count) * instances,
+            instances,
+            uniformBytes,
+            mesh.vertices.size() * sizeof(float) + mesh.indices.size() * sizeof(unsigned int),
+            counts,
+            static_cast<double>(counts.vertexShaderInvocations) / triangles,
+            core::mesh::acmr(mesh, CacheSize)};
+        percentiles(cpu, result.cpu);
+        percentiles(gpu, result.gpu);
+        return result;
+    }
+
+    // Counts the fallback queries cannot measure come out as `missing`
+    // rather than as 0.
+    std::string exactValue(const Result &result, const char *format, double value, const char *missing)
+    {
+        if (!result.statistics.exact)
+        {
+            return missing;
+        }
+        char text[32];
+        std::snprintf(text, sizeof(text), format, value);
+        return text;
+    }
+
+    void writeCsv(std::FILE *out, const std::vector<Result> &results)
+    {
+        std::fprintf(out, "shape,segments,instances,frames,fps,cpu_p50_ms,cpu_p95_ms,cpu_p99_ms,gpu_p50_ms,gpu_p95_ms,gpu_p99_ms,"
+                          "vertices_per_frame,draw_calls_per_frame,uniform_bytes_per_frame,mesh_bytes,"
+                          "exact_statistics,vs_invocations_per_draw,primitives_per_draw,fs_invocations_per_draw,samples_passed_per_draw,"
+                          "acmr_measured,acmr_theoretical\n");
+        for (const Result &result : results)
+        {
+            std::fprintf(
+                out,
+                "%s,%zu,%zu,%llu,%.1f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%zu,%zu,%zu,%zu,%d,%s,%llu,%s,%llu,%s,%.4f\n",
+                result.shape.c_str(),
+                result.segments,
+                result.instances,
+                static_cast<unsigned long long>(result.frames),
+                result.fps,
+                result.cpu[0],
+                result.cpu[1],
+                result.cpu[2],
+                result.gpu[0],
+                result.gpu[1],
+                result.gpu[2],
+                result.vertices,
+                result.drawCalls,
+                result.uniformBytes,
+                result.meshBytes,
+                result.statistics.exact,
+                exactValue(result, "%.0f", result.statistics.vertexShaderInvocations, "").c_str(),
+                static_cast<unsigned long long>(result.statistics.primitives),
+                exactValue(result, "%.0f", result.statistics.fragmentShaderInvocations, "").c_str(),
+                static_cast<unsigned long long>(result.statistics.samplesPassed),
+                exactValue(result, "%.4f", result.measuredAcmr, "").c_str(),
+                result.theoreticalAcmr);
+        }
+    }
+
+    void writeJson(std::FILE *out, const std::vector<Result> &results)
+    {
+        std::fprintf(out, "[\n");
+        for (std::size_t result_n = 0; result_n < results.size(); result_n++)
+        {
+            const Result &result = results[result_n];
+            std::fprintf(
+                out,
+                "  {\"shape\": \"%s\", \"segments\": %zu, \"instances\": %zu, \"frames\": %llu, \"fps\": %.1f, "
+                "\"cpu_ms\": {\"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f}, "
+                "\"gpu_ms\": {\"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f}, "
+                "\"vertices_per_frame\": %zu, \"draw_calls_per_frame\": %zu, \"uniform_bytes_per_frame\": %zu, \"mesh_bytes\": %zu, "
+                "\"per_draw\": {\"exact\": %s, \"vs_invocations\": %s, \"primitives\": %llu, \"fs_invocations\": %s, \"samples_passed\": %llu}, "
+                "\"acmr\": {\"measured\": %s, \"theoretical\": %.4f}}%s\n",
+                result.shape.c_str(),
+                result.segments,
+                result.instances,
+                static_cast<unsigned long long>(result.frames),
+                result.fps,
+                result.cpu[0],
+                result.cpu[1],
+                result.cpu[2],
+                result.gpu[0],
+                result.gpu[1],
+                result.gpu[2],
+                result.vertices,
+                result.drawCalls,
+                result.uniformBytes,
+                result.meshBytes,
+                result.statistics.exact ? "true" : "false",
+                exactValue(result, "%.0f", result.statistics.vertexShaderInvocations, "null").c_str(),
+                static_cast<unsigned long long>(result.statistics.primitives),
+                exactValue(result, "%.0f", result.statistics.fragmentShaderInvocations, "null").c_str(),
+                static_cast<unsigned long long>(result.statistics.samplesPassed),
+                exactValue(result, "%.4f", result.measuredAcmr, "null").c_str(),
+                result.theoreticalAcmr,
+                result_n + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(out, "]\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::size_t> segmentCounts = {8, 64, 512, 4096};
+    std::vector<std::size_t> instanceCounts = {1, 16, 256};
+    bool csv = false;
+    const char *output = nullptr;
+
+    // Everything not recognised here goes to the application.
+    std::vector<char *> applicationArguments = {argv[0]};
+    for (int argument_n = 1; argument_n < argc; argument_n++)
+    {
+        const bool hasValue = argument_n + 1 < argc;
+        if (std::strcmp(argv[argument_n], "--segments") == 0 && hasValue)
+        {
+            segmentCounts = parseList(argv[++argument_n]);
+            if (segmentCounts.empty())
+            {
+                std::fprintf(stderr, "bench_shapes: --segments takes positive counts like 8,64,512, not '%s'\n", argv[argument_n]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[argument_n], "--instances") == 0 && hasValue)
+        {
+            instanceCounts = parseList(argv[++argument_n]);
+            if (instanceCounts.empty())
+            {
+                std::fprintf(stderr, "bench_shapes: --instances takes positive counts like 1,16,256, not '%s'\n", argv[argument_n]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (std::strcmp(argv[argument_n], "--csv") == 0)
+        {
+            csv = true;
+        }
+        else if (std::strcmp(argv[argument_n], "--output") == 0 && hasValue)
+        {
+            output = argv[++argument_n];
+        }
+        else
+        {
+            applicationArguments.push_back(argv[argument_n]);
+        }
+    }
+
+    core::ApplicationConfig defaults;
+    defaults.headless = true;
+    defaults.title = "bench_shapes";
+    core::ApplicationConfig config = core::parseArguments(static_cast<int>(applicationArguments.size()), applicationArguments.data(), defaults);
+
+    // Keeps stdout clean for the report.
+    core::log::threshold = core::log::Level::Warning;
+    core::Application application(config);
+    if (!application.valid())
+    {
+        return EXIT_FAILURE;
+    }
+
+    const EmbeddedShader &vertexShader = basic_vertex_variants[basic_vertex_feature::TRANSFORM];
+    core::ProgramHandle program = application.programs().acquire(vertexShader, basic_fragment, basic_vertex_feature::TRANSFORM);
+    if (!program)
+    {
+        return EXIT_FAILURE;
+    }
+    if (program->uniformBlockIndex("Transform") != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(program->id(), program->uniformBlockIndex("Transform"), uniforms::Transform::binding);
+    }
+    glUseProgram(program->id());
+
+    std::vector<Result> results;
+    for (const Shape &shape : Shapes)
+    {
+        const std::vector<std::size_t> segments = shape.segmented ? segmentCounts : std::vector<std::size_t>{0};
+        for (std::size_t segment : segments)
+        {
+            for (std::size_t instances : instanceCounts)
+            {
+                results.push_back(measure(application, shape, segment, instances, config.frames));
+            }
+        }
+    }
+
+    std::FILE *out = output ? std::fopen(output, "w") : stdout;
+    if (!out)
+    {
+        std::fprintf(stderr, "bench_shapes: cannot write %s\n", output);
+        return EXIT_FAILURE;
+    }
+    csv ? writeCsv(out, results) : writeJson(out, results);
+    if (out != stdout)
+    {
+        std::fclose(out);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+#ifndef CORE_APPLICATION_HEADER
+#define CORE_APPLICATION_HEADER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <core/damage_tracker.hpp>
+#include <core/frame.hpp>
+#include <core/frame_pacer.hpp>
+#include <core/gpu_profiler.hpp>
+#include <core/headless.hpp>
+#include <core/overdraw.hpp>
+#include <core/program_cache.hpp>
+#include <core/program_registry.hpp>
+#include <core/render_target.hpp>
+#include <core/uniform_ring.hpp>
+
+namespace core
+{
+    class Application;
+
+    struct ApplicationConfig
+    {
+        int width = 800;
+        int height = 600;
+        const char *title = "LearnOpenGL";
+        std::size_t pipelineDepth = 2;
+        PacingMode pacing = PacingMode::Vsync;
+        // Windowed only: after input, a resize, Application::invalidate() or
+        // while the scene is animating, redraw; otherwise sleep in
+        // glfwWaitEvents() instead of presenting the same frame again.
+        bool renderOnDemand = true;
+        // Frames that report their damage (FrameCommands::partial) only
+        // redraw it where DamageTracker::worthwhile(); off, every frame is
+        // drawn whole.
+        bool partialRedraw = true;
+        // Frame rate PacingMode::Limited holds.
+        double targetFps = 60;
+
+        // No window: frames go to an offscreen target of width x height.
+        bool headless = false;
+        // Stop after this many frames; 0 runs until the window closes.
+        // Headless runs default to 300.
+        std::uint64_t frames = 0;
+        // Headless only: the last frame is written here as a PPM.
+        std::string capture;
+        // Times clear, draws and present with GPU timestamp queries.
+        bool profileGpu = false;
+        // Counts and times GL calls from the start (F3 toggles it while
+        // running).
+        bool glCalls = false;
+        // Debug context with KHR_debug output; driver performance messages
+        // are counted per frame.
+        bool glDebug = false;
+        // Shows fragments per pixel as a heatmap instead of the scene.
+        bool overdraw = false;
+        // CPU zones are written here as Chrome trace JSON after the run
+        // (needs CORE_PROFILE).
+        std::string trace;
+    };
+
+    // Reads --headless, --frames <n>, --size <width>x<height>, --continuous,
+    // --full-redraw, --pacing <vsync|off|adaptive|limit>, --target-fps <n>,
+    // --capture <file.ppm>, --profile-gpu, --gl-calls, --gl-debug,
+    // --overdraw and --trace <file.json> on top of `defaults`.
+    ApplicationConfig parseArguments(int argc, char **argv, ApplicationConfig defaults = {});
+
+    // What an example draws. setup() runs once on the GL thread with the
+    // context current; build() fills a frame on a job-system worker while
+    // the previous one is presented, so it must not call GL.
+    class Scene
+    {
+    public:
+        virtual ~Scene() = default;
+
+        // Returns false to abort the run.
+        virtual bool setup(Application &application) = 0;
+
+        virtual void build(FrameCommands &frame, std::uint64_t frameIndex) = 0;
+
+        // True while build() produces a different frame every time even
+        // without input; static scenes are only redrawn when something
+        // changes. Their frames start out partial with no damage (see
+        // FrameCommands::partial), so build() need not say nothing moved.
+        virtual bool animating() const
+        {
+            return false;
+        }
+
+        // GLFW key and action (GLFW_PRESS, ...), on the GL thread.
+        virtual void onKey(int /*key*/, int /*action*/)
+        {
+        }
+    };
+
+    // The window (or headless context and offscreen target), GL loaders,
+    // program registry, uniform ring and frame loop every example shares.
+    class Application
+    {
+    public:
+        explicit Application(const ApplicationConfig &config = {});
+        ~Application();
+
+        Application(const Application &) = delete;
+        Application &operator=(const Application &) = delete;
+
+        // False when the window or the GL loader could not be set up.
+        bool valid() const
+        {
+            return registry != nullptr;
+        }
+
+        // Null when headless.
+        GLFWwindow *glfwWindow() const
+        {
+            return window;
+        }
+
+        ProgramRegistry &programs()
+        {
+            return *registry;
+        }
+
+        UniformRing &uniforms()
+        {
+            return *uniformRing;
+        }
+
+        // Sets the scene up and presents its frames until the window closes.
+        // Returns the process exit code.
+        int run(Scene &scene);
+
+        // Asks for a redraw, e.g. after a resource update; any thread.
+        void invalidate();
+
+    private:
+        static void onFrameBufferSize(GLFWwindow *window, int width, int height);
+        static void onKey(GLFWwindow *window, int key, int scancode, int action, int mods);
+        static void onRefresh(GLFWwindow *window);
+
+        bool running(std::uint64_t frame) const;
+        // Applies the latest framebuffer size the callback recorded, once
+        // per frame however many resize events came in.
+        void applyResize();
+        // Blocks until the next event when nothing needs redrawing; false
+        // when a frame should be drawn.
+        bool idle(Scene &scene, FramePacer &pacer);
+
+        ApplicationConfig config;
+        GLFWwindow *window = nullptr;
+        Scene *scene = nullptr;
+
+        // Framebuffer size; onFrameBufferSize() only records it, see
+        // applyResize().
+        int framebufferWidth = 0;
+        int framebufferHeight = 0;
+        bool resizePending = false;
+        std::uint64_t resizeEvents = 0;
+        std::uint64_t resizesApplied = 0;
+
+        std::atomic<bool> dirty{true};
+        // Like `dirty`, for the damage tracker.
+        std::atomic<bool> redrawAll{true};
+        std::size_t pendingFrames = 0;
+        std::uint64_t skippedFrames = 0;
+        double idleSeconds = 0;
+        double idleCpuSeconds = 0;
+
+        std::unique_ptr<HeadlessContext> headless;
+        std::unique_ptr<RenderTarget> offscreen;
+        std::unique_ptr<ProgramCache> programCache;
+        std::unique_ptr<ProgramRegistry> registry;
+        std::unique_ptr<UniformRing> uniformRing;
+        std::unique_ptr<GpuProfiler> gpuProfiler;
+        std::unique_ptr<Overdraw> overdraw;
+        std::unique_ptr<DamageTracker> damage;
+    };
+
+    // The whole main() of an example.
+    template <typename SceneType>
+    int runScene(int argc, char **argv, const ApplicationConfig &defaults = {})
+    {
+        const ApplicationConfig config = parseArguments(argc, argv, defaults);
+        Application application(config);
+        if (!application.valid())
+        {
+            return EXIT_FAILURE;
+        }
+        // Declared after the application, so its GL objects go first.
+        SceneType scene;
+        return application.run(scene);
+    }
+}
+
+#endif
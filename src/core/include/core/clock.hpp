@@ -0,0 +1,27 @@
+#ifndef CORE_CLOCK_HEADER
+#define CORE_CLOCK_HEADER
+
+#include <chrono>
+
+namespace core
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Captured while the core library is initialised, i.e. before main().
+    Clock::time_point startupTime();
+
+    inline double millisecondsBetween(Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    inline double millisecondsSinceStartup()
+    {
+        return millisecondsBetween(startupTime(), Clock::now());
+    }
+
+    // CPU time used by all threads of the process so far.
+    double processCpuSeconds();
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef CORE_DAMAGE_TRACKER_HEADER
+#define CORE_DAMAGE_TRACKER_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <core/frame.hpp>
+#include <core/render_target.hpp>
+
+namespace core
+{
+    // Partial redraw. Frames draw into a target that keeps its contents
+    // between frames (the offscreen target when headless, a back buffer the
+    // size of the window otherwise), and frames reporting their damage (see
+    // FrameCommands::partial) are scissored to it, so the rest still shows
+    // the previous frame. Windowed, present() copies the back buffer to the
+    // window (only the damage of the frames the window's buffer missed
+    // where EGL_EXT_buffer_age tells its age) and swaps with
+    // eglSwapBuffersWithDamageKHR where the context is EGL and has it, so
+    // the compositor only takes the damage too. The share of pixels
+    // redrawn is logged every few hundred frames.
+    class DamageTracker
+    {
+    public:
+        // `window` is null when headless.
+        explicit DamageTracker(GLFWwindow *window);
+
+        // Whether drawing only the damage saves more than it costs: always
+        // headless, where frames already go to a target that keeps them.
+        // Windowed, every frame adds a copy into the window, which only
+        // shrinks to the damage (or pays off at the compositor) with buffer
+        // age or swap with damage.
+        static bool worthwhile(GLFWwindow *window);
+
+        DamageTracker(const DamageTracker &) = delete;
+        DamageTracker &operator=(const DamageTracker &) = delete;
+
+        // Draws the next `frames` frames whole, for changes the damage the
+        // scene reports does not cover (input, Application::invalidate()).
+        void invalidate(std::size_t frames);
+
+        // Binds the target: `offscreen` when headless, the back buffer
+        // (resized to width x height, see RenderTarget::resize())
+        // otherwise. Returns the regions of `frame` to redraw for submit(),
+        // or null to redraw all of it.
+        const std::vector<Rect> *begin(const FrameCommands &frame, RenderTarget *offscreen, int width, int height);
+
+        // Windowed only: copies the back buffer to the window and swaps.
+        void present();
+
+        void report();
+
+    private:
+        // Older window buffers are copied whole.
+        static constexpr std::size_t MaxBufferAge = 4;
+        static constexpr std::uint64_t ReportInterval = 300;
+
+        void regionsOf(const FrameCommands &frame, int width, int height);
+        int bufferAge() const;
+
+        GLFWwindow *window;
+        std::unique_ptr<RenderTarget> back;
+        GLuint framebuffer = 0;
+        int width = 0;
+        int height = 0;
+        std::size_t wholeFrames = 1;
+        std::vector<Rect> regions;
+        bool whole = true;
+        // Regions of the latest frames, newest last.
+        std::deque<std::vector<Rect>> history;
+        std::vector<Rect> copies;
+
+        // EGLDisplay, EGLSurface and eglSwapBuffersWithDamageKHR, kept
+        // opaque here; null unless the window's context is EGL.
+        void *display = nullptr;
+        void *surface = nullptr;
+        void *swapWithDamage = nullptr;
+        bool queryAge = false;
+
+        std::uint64_t frames = 0;
+        std::uint64_t wholeFrameCount = 0;
+        double drawnPixels = 0;
+        double copiedPixels = 0;
+        double totalPixels = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,258 @@
+#ifndef CORE_FRAME_HEADER
+#define CORE_FRAME_HEADER
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <core/gpu_profiler.hpp>
+#include <core/jobs.hpp>
+#include <core/mesh.hpp>
+#include <core/profile.hpp>
+#include <core/uniform_ring.hpp>
+
+namespace core
+{
+    // A uniform block staged in FrameCommands::uniforms, bound to the
+    // uniform buffer binding point `binding`. Empty when `size` is 0.
+    struct UniformRange
+    {
+        GLuint binding = 0;
+        std::size_t offset = 0;
+        std::size_t size = 0;
+    };
+
+    // Framebuffer pixels, origin at the bottom left like glScissor().
+    struct Rect
+    {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    struct DrawCommand
+    {
+        GLenum mode;
+        GLsizei count;
+        // First vertex, or first index when `indexType` is set.
+        GLint first = 0;
+        GLenum indexType = GL_NONE;
+        // Bound for the draw; 0 draws with whatever is bound.
+        GLuint vertexArray = 0;
+        // Per-draw block, bound just before the draw.
+        UniformRange uniforms = {};
+        // GPU profiler pass the draw is timed under.
+        const char *label = "draw";
+    };
+
+    // Everything the GL thread needs to issue one frame; built off-thread.
+    struct FrameCommands
+    {
+        std::array<float, 4> clearColor = {.0f, .0f, .0f, 1.0f};
+        std::vector<DrawCommand> draws;
+
+        // With `partial` set, `damage` covers everything that differs from
+        // the previous frame (in normalized device coordinates, e.g. the old
+        // and new bounds of a moving shape; empty when nothing moved), and a
+        // DamageTracker redraws only that. Application sets `partial` for
+        // static scenes before Scene::build() and clears `damage`.
+        bool partial = false;
+        std::vector<mesh::Bounds> damage;
+
+        // Uniform block data of the whole frame, uploaded in one go.
+        std::vector<unsigned char> uniforms;
+        // What stage() rounds offsets up to: UniformRing::alignment() of
+        // the ring the frame is submitted through.
+        std::size_t uniformAlignment = 256;
+        // Per-frame blocks, bound once before the draws.
+        std::vector<UniformRange> uniformBindings;
+
+        // Appends a block (typically a generated uniforms:: struct) to
+        // `uniforms`; the frame builder clears `uniforms` first.
+        template <typename Block>
+        UniformRange stage(GLuint binding, const Block &block)
+        {
+            static_assert(std::is_trivially_copyable_v<Block>);
+            const std::size_t offset = (uniforms.size() + uniformAlignment - 1) / uniformAlignment * uniformAlignment;
+            uniforms.resize(offset + sizeof(Block));
+            std::memcpy(uniforms.data() + offset, &block, sizeof(Block));
+            return {binding, offset, sizeof(Block)};
+        }
+    };
+
+    // Issues the commands on the calling (GL) thread. Staged uniforms go
+    // through `ring`, and are left unbound without one. With a `profiler`,
+    // the clear and every draw are timed as GPU passes. With `regions`, the
+    // clear and draws are repeated scissored to each of them instead of
+    // covering the whole framebuffer; an empty list draws nothing.
+    void submit(
+        const FrameCommands &frame,
+        UniformRing *ring = nullptr,
+        GpuProfiler *profiler = nullptr,
+        const std::vector<Rect> *regions = nullptr);
+
+    class FramePipelineStats
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        explicit FramePipelineStats(std::size_t depth) : depth(depth)
+        {
+        }
+
+        // `stall` is the time the GL thread waited for the build to finish.
+        void record(Clock::duration build, Clock::duration stall, Clock::duration gpuWait, Clock::duration latency);
+
+    private:
+        void report();
+
+        static constexpr std::uint64_t ReportInterval = 300;
+
+        const std::size_t depth;
+        bool presentedFirstFrame = false;
+        std::uint64_t frames = 0;
+        double buildSeconds = 0;
+        double stallSeconds = 0;
+        double gpuWaitSeconds = 0;
+        double latencySeconds = 0;
+        double maxLatencySeconds = 0;
+    };
+
+    // Builds frame N + 1 .. N + depth - 1 on the job system while the GL
+    // thread submits and presents frame N.
+    //
+    //     Frame &frame = pipeline.beginFrame();
+    //     ... submit frame ...
+    //     glfwSwapBuffers(window);
+    //     pipeline.endFrame();
+    //
+    // Each slot keeps its own Frame, so the build callback may reuse the
+    // storage of the frame that previously occupied the slot. A fence per
+    // slot keeps the GPU at most `depth` frames behind the CPU.
+    template <typename Frame>
+    class FramePipeline
+    {
+    public:
+        using Clock = FramePipelineStats::Clock;
+        using Build = std::function<void(Frame &frame, std::uint64_t frameIndex)>;
+
+        FramePipeline(std::size_t depth, Build build, JobSystem &jobs = core::jobs())
+            : build(std::move(build)), jobs(jobs), slots(depth), stats(depth)
+        {
+            for (std::uint64_t frame_n = 0; frame_n < depth; frame_n++)
+            {
+                schedule(frame_n);
+            }
+        }
+
+        ~FramePipeline()
+        {
+            for (Slot &slot : slots)
+            {
+                jobs.wait(slot.task);
+                if (slot.fence)
+                {
+                    glDeleteSync(slot.fence);
+                }
+            }
+        }
+
+        FramePipeline(const FramePipeline &) = delete;
+        FramePipeline &operator=(const FramePipeline &) = delete;
+
+        Frame &beginFrame()
+        {
+            CORE_PROFILE_ZONE("frame wait");
+            Slot &slot = current();
+
+            Clock::time_point waitStart = Clock::now();
+            if (slot.fence)
+            {
+                glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+                glDeleteSync(slot.fence);
+                slot.fence = nullptr;
+            }
+            Clock::time_point buildWaitStart = Clock::now();
+            jobs.wait(slot.task);
+            Clock::time_point waitEnd = Clock::now();
+
+            gpuWait = buildWaitStart - waitStart;
+            stall = waitEnd - buildWaitStart;
+            return slot.frame;
+        }
+
+        void endFrame()
+        {
+            Slot &slot = current();
+            slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+            Clock::time_point presented = Clock::now();
+            stats.record(slot.buildEnd - slot.buildStart, stall, gpuWait, presented - slot.buildStart);
+
+            schedule(frameIndex + slots.size());
+            frameIndex++;
+        }
+
+        // Builds the frames not yet presented again. For the GL thread coming
+        // back from a wait: frames built before it would show the state from
+        // before the wait and count the wait as latency.
+        void restart()
+        {
+            for (std::uint64_t target = frameIndex; target < frameIndex + slots.size(); target++)
+            {
+                jobs.wait(slots[target % slots.size()].task);
+                schedule(target);
+            }
+        }
+
+        std::uint64_t frame() const
+        {
+            return frameIndex;
+        }
+
+    private:
+        struct Slot
+        {
+            Frame frame;
+            TaskHandle task;
+            Clock::time_point buildStart;
+            Clock::time_point buildEnd;
+            GLsync fence = nullptr;
+        };
+
+        Slot &current()
+        {
+            return slots[frameIndex % slots.size()];
+        }
+
+        void schedule(std::uint64_t target)
+        {
+            Slot &slot = slots[target % slots.size()];
+            slot.task = jobs.run(
+                [this, &slot, target]
+                {
+                    CORE_PROFILE_ZONE("frame build");
+                    slot.buildStart = Clock::now();
+                    build(slot.frame, target);
+                    slot.buildEnd = Clock::now();
+                });
+        }
+
+        Build build;
+        JobSystem &jobs;
+        std::vector<Slot> slots;
+        FramePipelineStats stats;
+        std::uint64_t frameIndex = 0;
+        Clock::duration stall{};
+        Clock::duration gpuWait{};
+    };
+}
+
+#endif
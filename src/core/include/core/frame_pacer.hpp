@@ -0,0 +1,71 @@
+#ifndef CORE_FRAME_PACER_HEADER
+#define CORE_FRAME_PACER_HEADER
+
+#include <cstdint>
+#include <vector>
+
+#include <core/clock.hpp>
+
+namespace core
+{
+    enum class PacingMode
+    {
+        // Swap interval 1.
+        Vsync,
+        // Swap interval 0: as fast as the GPU goes, tearing allowed.
+        Uncapped,
+        // Swap interval -1: vsync, but late frames swap immediately. Falls
+        // back to Vsync without *_EXT_swap_control_tear.
+        Adaptive,
+        // Swap interval 0 with a CPU limiter holding `targetFps`.
+        Limited
+    };
+
+    // Returns false for names other than vsync, off, adaptive and limit.
+    bool parsePacingMode(const char *name, PacingMode &mode);
+
+    const char *pacingModeName(PacingMode mode);
+
+    // Sets the swap interval and paces presents. Call wait() right before
+    // each swap: in Limited mode it sleeps until shortly before the next
+    // deadline and spins the rest of the way, since sleeps overshoot by up
+    // to a scheduler tick. Present-to-present intervals, their jitter and
+    // the process CPU usage are logged every few hundred frames.
+    class FramePacer
+    {
+    public:
+        FramePacer(PacingMode mode, double targetFps = 60);
+
+        // Applies the swap interval to the current GLFW context; headless
+        // runs skip this and only use the limiter.
+        void apply();
+
+        void wait();
+
+        // Forgets the previous present, so time spent idle (see
+        // ApplicationConfig::renderOnDemand) is neither an interval nor a
+        // late frame.
+        void resume();
+
+        PacingMode mode() const
+        {
+            return pacingMode;
+        }
+
+    private:
+        void report();
+
+        static constexpr std::uint64_t ReportInterval = 300;
+
+        PacingMode pacingMode;
+        const Clock::duration period;
+        Clock::time_point deadline{};
+        Clock::time_point previous{};
+        std::vector<double> intervals;
+        std::uint64_t lateFrames = 0;
+        Clock::time_point windowStart{};
+        double windowCpuStart = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef CORE_GL_HEADER
+#define CORE_GL_HEADER
+
+#include <string_view>
+
+#include <glad/glad.h>
+
+// Extension entry points and tokens beyond the GL 3.3 core profile the glad
+// loader was generated for. Call load() once after gladLoadGLLoader(); entry
+// points stay null when the context does not support them.
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+#ifndef GL_SHADER_BINARY_FORMAT_SPIR_V
+#define GL_SHADER_BINARY_FORMAT_SPIR_V 0x9551
+#endif
+
+#ifndef GL_VERTICES_SUBMITTED
+#define GL_VERTICES_SUBMITTED 0x82EE
+#define GL_PRIMITIVES_SUBMITTED 0x82EF
+#define GL_VERTEX_SHADER_INVOCATIONS 0x82F0
+#define GL_FRAGMENT_SHADER_INVOCATIONS 0x82F4
+#define GL_CLIPPING_INPUT_PRIMITIVES 0x82F6
+#endif
+
+#ifndef GL_DEBUG_OUTPUT
+#define GL_CONTEXT_FLAG_DEBUG_BIT 0x00000002
+#define GL_DEBUG_OUTPUT 0x92E0
+#define GL_DEBUG_OUTPUT_SYNCHRONOUS 0x8242
+#define GL_DEBUG_SOURCE_API 0x8246
+#define GL_DEBUG_SOURCE_WINDOW_SYSTEM 0x8247
+#define GL_DEBUG_SOURCE_SHADER_COMPILER 0x8248
+#define GL_DEBUG_SOURCE_THIRD_PARTY 0x8249
+#define GL_DEBUG_SOURCE_APPLICATION 0x824A
+#define GL_DEBUG_SOURCE_OTHER 0x824B
+#define GL_DEBUG_TYPE_ERROR 0x824C
+#define GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR 0x824D
+#define GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR 0x824E
+#define GL_DEBUG_TYPE_PORTABILITY 0x824F
+#define GL_DEBUG_TYPE_PERFORMANCE 0x8250
+#define GL_DEBUG_TYPE_OTHER 0x8251
+#define GL_DEBUG_TYPE_MARKER 0x8268
+#define GL_DEBUG_TYPE_PUSH_GROUP 0x8269
+#define GL_DEBUG_TYPE_POP_GROUP 0x826A
+#define GL_DEBUG_SEVERITY_HIGH 0x9146
+#define GL_DEBUG_SEVERITY_MEDIUM 0x9147
+#define GL_DEBUG_SEVERITY_LOW 0x9148
+#define GL_DEBUG_SEVERITY_NOTIFICATION 0x826B
+#endif
+
+namespace core::gl
+{
+    typedef void (APIENTRYP PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+    typedef void (APIENTRYP PFNGLGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+    typedef void (APIENTRYP PFNGLPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+    typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+    typedef void (APIENTRYP PFNGLSHADERBINARYPROC)(GLsizei count, const GLuint *shaders, GLenum binaryFormat, const void *binary, GLsizei length);
+    typedef void (APIENTRYP PFNGLSPECIALIZESHADERPROC)(GLuint shader, const GLchar *entryPoint, GLuint count, const GLuint *constantIndex, const GLuint *constantValue);
+    typedef void (APIENTRYP PFNGLDEBUGMESSAGECALLBACKPROC)(GLDEBUGPROC callback, const void *userParam);
+    typedef void (APIENTRYP PFNGLDEBUGMESSAGECONTROLPROC)(GLenum source, GLenum type, GLenum severity, GLsizei count, const GLuint *ids, GLboolean enabled);
+
+    struct Extensions
+    {
+        bool parallelShaderCompile = false;
+        // GL 4.1 / ARB_get_program_binary with at least one binary format.
+        bool programBinary = false;
+        // GL 4.6 / ARB_gl_spirv.
+        bool spirv = false;
+        // GL 4.3 / KHR_debug. Messages only flow on a debug context.
+        bool debug = false;
+        // GL 4.6 / ARB_pipeline_statistics_query.
+        bool pipelineStatistics = false;
+    };
+
+    extern PFNGLMAXSHADERCOMPILERTHREADSKHRPROC maxShaderCompilerThreads;
+    extern PFNGLGETPROGRAMBINARYPROC getProgramBinary;
+    extern PFNGLPROGRAMBINARYPROC programBinary;
+    extern PFNGLPROGRAMPARAMETERIPROC programParameteri;
+    extern PFNGLSHADERBINARYPROC shaderBinary;
+    extern PFNGLSPECIALIZESHADERPROC specializeShader;
+    extern PFNGLDEBUGMESSAGECALLBACKPROC debugMessageCallback;
+    extern PFNGLDEBUGMESSAGECONTROLPROC debugMessageControl;
+
+    void load(GLADloadproc loader);
+
+    const Extensions &extensions();
+
+    bool supports(std::string_view extension);
+
+    // Whether a space-separated list such as eglQueryString(EGL_EXTENSIONS)
+    // names `name`. A null list names nothing.
+    bool hasExtension(const char *extensions, const char *name);
+}
+
+#endif
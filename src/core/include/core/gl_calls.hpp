@@ -0,0 +1,34 @@
+#ifndef CORE_GL_CALLS_HEADER
+#define CORE_GL_CALLS_HEADER
+
+#include <cstdint>
+
+// Driver overhead diagnostics. intercept(true) swaps the glad entry points
+// the examples use for wrappers that count calls, time them on the CPU and
+// add up the bytes handed to glBufferData, glBufferSubData, glTexImage*,
+// glTexSubImage* and write-mapped glMapBufferRange. intercept(false) puts
+// the loaded pointers back, so nothing is paid while it is off.
+//
+// Call after gladLoadGLLoader(), on the GL thread.
+namespace core::gl::calls
+{
+    struct Counters
+    {
+        std::uint64_t calls = 0;
+        std::uint64_t nanoseconds = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    void intercept(bool enabled);
+
+    bool intercepting();
+
+    // Totals since the previous endFrame(); logs the average every few
+    // hundred frames.
+    Counters endFrame();
+
+    // Logs every entry point called so far, most expensive first.
+    void report();
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef CORE_GL_DEBUG_HEADER
+#define CORE_GL_DEBUG_HEADER
+
+#include <cstddef>
+
+#include <glad/glad.h>
+
+// KHR_debug output. install() routes driver messages through a callback:
+// performance messages (stalls, shader recompiles, implicit syncs) go into a
+// lock-free queue that endFrame() drains and counts on the GL thread, since
+// drivers may call back from their own threads; everything else is logged
+// right away at a level matching its severity.
+//
+// Drivers only promise messages on debug contexts (ApplicationConfig::glDebug).
+namespace core::gl::debug
+{
+    // False when the context lacks GL 4.3 / KHR_debug. Notifications start
+    // filtered out.
+    bool install();
+
+    // Turns messages matching all three on or off; GL_DONT_CARE matches any.
+    void filter(GLenum source, GLenum type, GLenum severity, bool enabled);
+
+    // Performance messages since the previous call. The first message of
+    // each id is logged with its text; counts are logged every few hundred
+    // frames.
+    std::size_t endFrame();
+
+    // Logs how often each performance message came up.
+    void report();
+}
+
+#endif
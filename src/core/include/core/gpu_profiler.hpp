@@ -0,0 +1,100 @@
+#ifndef CORE_GPU_PROFILER_HEADER
+#define CORE_GPU_PROFILER_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace core
+{
+    // GPU time of named passes, from GL_TIMESTAMP queries taken out of a
+    // recycled pool. A frame's results are collected once the GPU has
+    // written them (GL_QUERY_RESULT_AVAILABLE), typically a couple of frames
+    // later, so the profiler never waits on the GPU. Each pass keeps its
+    // last `window` samples for rolling percentiles.
+    //
+    //     profiler.beginFrame();
+    //     {
+    //         GpuProfiler::Zone zone(profiler, "clear");
+    //         glClear(...);
+    //     }
+    //     profiler.endFrame();
+    //
+    // Zones may nest, and zones of the same name in one frame add up. Names
+    // must outlive the profiler (string literals).
+    class GpuProfiler
+    {
+    public:
+        class Zone
+        {
+        public:
+            // Does nothing when `profiler` is null.
+            Zone(GpuProfiler *profiler, const char *name);
+            ~Zone();
+
+            Zone(const Zone &) = delete;
+            Zone &operator=(const Zone &) = delete;
+
+        private:
+            GpuProfiler *profiler;
+            std::size_t index;
+        };
+
+        explicit GpuProfiler(std::size_t window = 240);
+        ~GpuProfiler();
+
+        GpuProfiler(const GpuProfiler &) = delete;
+        GpuProfiler &operator=(const GpuProfiler &) = delete;
+
+        void beginFrame();
+        void endFrame();
+
+        // Logs p50/p95/p99 of every pass.
+        void report() const;
+
+    private:
+        struct Timing
+        {
+            const char *name;
+            GLuint begin;
+            GLuint end;
+        };
+
+        struct Frame
+        {
+            std::vector<Timing> timings;
+            // The query written last; the frame is complete once it is.
+            GLuint last = 0;
+        };
+
+        struct Pass
+        {
+            const char *name;
+            std::vector<double> samples;
+            std::size_t next = 0;
+        };
+
+        std::size_t begin(const char *name);
+        void end(std::size_t index);
+
+        GLuint acquire();
+        void collect();
+        void record(const char *name, double milliseconds);
+
+        static constexpr std::uint64_t ReportInterval = 300;
+
+        const std::size_t window;
+        std::vector<GLuint> pool;
+        std::vector<GLuint> queries;
+        Frame recording;
+        std::deque<Frame> pending;
+        std::vector<Pass> passes;
+        std::uint64_t frames = 0;
+    };
+}
+
+#endif
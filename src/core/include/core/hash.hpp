@@ -0,0 +1,32 @@
+#ifndef CORE_HASH_HEADER
+#define CORE_HASH_HEADER
+
+#include <cstdint>
+#include <string_view>
+
+namespace core
+{
+    constexpr std::uint64_t Fnv1aOffset = 1469598103934665603ull;
+    constexpr std::uint64_t Fnv1aPrime = 1099511628211ull;
+
+    // 64-bit FNV-1a; `hash` chains several inputs into one value.
+    constexpr std::uint64_t fnv1a64(std::string_view text, std::uint64_t hash = Fnv1aOffset)
+    {
+        for (char character : text)
+        {
+            hash = (hash ^ static_cast<unsigned char>(character)) * Fnv1aPrime;
+        }
+        return hash;
+    }
+
+    constexpr std::uint64_t hashCombine(std::uint64_t hash, std::uint64_t value)
+    {
+        for (int byte_n = 0; byte_n < 8; byte_n++)
+        {
+            hash = (hash ^ ((value >> (byte_n * 8)) & 0xFF)) * Fnv1aPrime;
+        }
+        return hash;
+    }
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef CORE_HEADLESS_HEADER
+#define CORE_HEADLESS_HEADER
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+namespace core
+{
+    // A GL 3.3 core context without a visible window, for benchmarks and
+    // tests on machines with no display or GPU. With EGL in the build it
+    // sits on Mesa's surfaceless platform (llvmpipe works), or a 1x1 pbuffer
+    // on the default display; otherwise on a hidden GLFW window. Rendering
+    // goes to a RenderTarget, never to a default framebuffer.
+    class HeadlessContext
+    {
+    public:
+        // `debug` asks for a debug context.
+        explicit HeadlessContext(bool debug = false);
+        ~HeadlessContext();
+
+        HeadlessContext(const HeadlessContext &) = delete;
+        HeadlessContext &operator=(const HeadlessContext &) = delete;
+
+        bool valid() const
+        {
+            return created;
+        }
+
+        // For gladLoadGLLoader() and gl::load().
+        GLADloadproc loader() const;
+
+    private:
+        bool created = false;
+        // EGLDisplay, EGLContext and EGLSurface, kept opaque here.
+        void *display = nullptr;
+        void *context = nullptr;
+        void *surface = nullptr;
+        GLFWwindow *window = nullptr;
+    };
+}
+
+#endif
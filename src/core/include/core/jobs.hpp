@@ -0,0 +1,127 @@
+#ifndef CORE_JOBS_HEADER
+#define CORE_JOBS_HEADER
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace core
+{
+    class JobSystem;
+
+    class Task
+    {
+    public:
+        explicit Task(std::function<void()> work) : work(std::move(work))
+        {
+        }
+
+        bool finished() const
+        {
+            return done.load(std::memory_order_acquire);
+        }
+
+    private:
+        friend class JobSystem;
+
+        std::function<void()> work;
+        // One reference is held by the pending submit() plus one per unfinished prerequisite.
+        std::atomic<int> pending{1};
+        std::atomic<bool> done{false};
+        std::mutex mutex;
+        std::vector<std::shared_ptr<Task>> successors;
+        // Under `mutex`: some thread may sleep in wait() until `done`.
+        bool awaited = false;
+    };
+
+    using TaskHandle = std::shared_ptr<Task>;
+
+    // Work-stealing scheduler.
+    //
+    // Every worker owns a deque: it pushes and pops its own work at the back
+    // while idle workers steal from the front of the others. Tasks submitted
+    // from outside the pool land in a shared injection queue. A thread that
+    // waits (wait(), parallelFor()) executes queued tasks instead of blocking,
+    // so a JobSystem with zero workers degrades to running everything on the
+    // caller. Once there is nothing left to run it spins briefly, then sleeps
+    // with the workers until its work finishes or more is queued.
+    class JobSystem
+    {
+    public:
+        explicit JobSystem(std::size_t workerCount);
+        ~JobSystem();
+
+        JobSystem(const JobSystem &) = delete;
+        JobSystem &operator=(const JobSystem &) = delete;
+
+        std::size_t workerCount() const
+        {
+            return workers.size();
+        }
+
+        TaskHandle createTask(std::function<void()> work);
+
+        // Makes `task` run only after `prerequisite` finished; call before submit(task).
+        void addDependency(const TaskHandle &task, const TaskHandle &prerequisite);
+
+        void submit(const TaskHandle &task);
+
+        TaskHandle run(std::function<void()> work);
+
+        void wait(const TaskHandle &task);
+
+        // Calls function(chunkBegin, chunkEnd) over [begin, end) split into
+        // chunks of at most `grain` items; returns once every chunk ran.
+        template <typename Function>
+        void parallelFor(std::size_t begin, std::size_t end, std::size_t grain, Function &&function)
+        {
+            if (end <= begin)
+            {
+                return;
+            }
+            if (end - begin <= grain || workers.empty())
+            {
+                function(begin, end);
+                return;
+            }
+            parallelForChunks(begin, end, grain, std::function<void(std::size_t, std::size_t)>(std::forward<Function>(function)));
+        }
+
+    private:
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<TaskHandle> tasks;
+        };
+
+        void parallelForChunks(std::size_t begin, std::size_t end, std::size_t grain, std::function<void(std::size_t, std::size_t)> function);
+
+        void helpUntil(const std::function<bool()> &ready);
+        void wakeSleepers();
+        void enqueue(TaskHandle task);
+        TaskHandle dequeue(std::size_t self);
+        bool runOne();
+        void execute(const TaskHandle &task);
+        void workerLoop(std::size_t index);
+
+        std::vector<std::unique_ptr<WorkQueue>> queues;
+        std::vector<std::thread> workers;
+
+        std::atomic<std::size_t> queued{0};
+        std::atomic<bool> stopping{false};
+        std::mutex sleepMutex;
+        std::condition_variable sleep;
+    };
+
+    // Process-wide scheduler sized to the machine; the calling thread is
+    // expected to help, so it uses one worker less than the hardware threads.
+    JobSystem &jobs();
+}
+
+#endif
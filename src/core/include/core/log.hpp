@@ -0,0 +1,153 @@
+#ifndef CORE_LOG_HEADER
+#define CORE_LOG_HEADER
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Asynchronous logger.
+//
+// A log call only copies its raw arguments into a lock-free ring buffer owned
+// by the calling thread; formatting and the actual write happen in batches on
+// a background writer thread. When a thread buffer is full the record is
+// dropped and counted instead of blocking the caller.
+//
+//     core::log::info("Key callback: {} action: {}", key, action);
+//
+// The format string must be a literal: only its address is stored.
+namespace core::log
+{
+    enum class Level : std::uint8_t
+    {
+        Debug,
+        Info,
+        Warning,
+        Error
+    };
+
+    enum class ArgumentType : std::uint8_t
+    {
+        Signed,
+        Unsigned,
+        Floating,
+        Boolean,
+        Character,
+        Pointer,
+        String
+    };
+
+    struct Argument
+    {
+        ArgumentType type;
+        union
+        {
+            std::int64_t i;
+            std::uint64_t u;
+            double f;
+            const void *p;
+        };
+        std::string_view text;
+    };
+
+    inline std::atomic<Level> threshold{Level::Debug};
+
+    namespace detail
+    {
+        void write(Level level, const char *format, const Argument *arguments, std::size_t count);
+
+        template <typename T>
+        Argument toArgument(const T &value)
+        {
+            Argument argument{};
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                argument.type = ArgumentType::Boolean;
+                argument.u = value;
+            }
+            else if constexpr (std::is_same_v<T, char>)
+            {
+                argument.type = ArgumentType::Character;
+                argument.u = static_cast<unsigned char>(value);
+            }
+            else if constexpr (std::is_enum_v<T>)
+            {
+                return toArgument(static_cast<std::underlying_type_t<T>>(value));
+            }
+            else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            {
+                argument.type = ArgumentType::Signed;
+                argument.i = value;
+            }
+            else if constexpr (std::is_integral_v<T>)
+            {
+                argument.type = ArgumentType::Unsigned;
+                argument.u = value;
+            }
+            else if constexpr (std::is_floating_point_v<T>)
+            {
+                argument.type = ArgumentType::Floating;
+                argument.f = value;
+            }
+            else if constexpr (std::is_convertible_v<const T &, std::string_view>)
+            {
+                argument.type = ArgumentType::String;
+                argument.text = value;
+            }
+            else
+            {
+                static_assert(std::is_pointer_v<T>, "unsupported log argument type");
+                argument.type = ArgumentType::Pointer;
+                argument.p = value;
+            }
+            return argument;
+        }
+
+        template <std::size_t N, typename... Args>
+        void log(Level level, const char (&format)[N], const Args &...args)
+        {
+            if (level < threshold.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            const std::array<Argument, sizeof...(Args)> arguments = {toArgument(args)...};
+            write(level, format, arguments.data(), arguments.size());
+        }
+    }
+
+    template <std::size_t N, typename... Args>
+    void debug(const char (&format)[N], const Args &...args)
+    {
+        detail::log(Level::Debug, format, args...);
+    }
+
+    template <std::size_t N, typename... Args>
+    void info(const char (&format)[N], const Args &...args)
+    {
+        detail::log(Level::Info, format, args...);
+    }
+
+    template <std::size_t N, typename... Args>
+    void warning(const char (&format)[N], const Args &...args)
+    {
+        detail::log(Level::Warning, format, args...);
+    }
+
+    template <std::size_t N, typename... Args>
+    void error(const char (&format)[N], const Args &...args)
+    {
+        detail::log(Level::Error, format, args...);
+    }
+
+    // Blocks until every record logged before the call has been written.
+    void flush();
+
+    // Total number of records dropped because a thread buffer was full. The
+    // writer also prints it on shutdown when it is not zero.
+    std::uint64_t droppedCount();
+}
+
+#endif
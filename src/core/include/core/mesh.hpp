@@ -0,0 +1,45 @@
+#ifndef CORE_MESH_HEADER
+#define CORE_MESH_HEADER
+
+#include <cstddef>
+#include <vector>
+
+#include <core/jobs.hpp>
+
+namespace core::mesh
+{
+    // Tightly packed xyz positions; `indices` is empty for unindexed meshes.
+    struct Mesh
+    {
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+    };
+
+    // Axis-aligned xy extent, e.g. of a shape in normalized device
+    // coordinates.
+    struct Bounds
+    {
+        float left = 0;
+        float bottom = 0;
+        float right = 0;
+        float top = 0;
+    };
+
+    // One independent (center, start, end) triangle per division.
+    Mesh circleFan(std::size_t divisions, JobSystem &jobs = core::jobs());
+
+    // Center plus one rim vertex per division, shared through indices.
+    Mesh circleIndexed(std::size_t divisions, JobSystem &jobs = core::jobs());
+
+    Bounds bounds(const Mesh &mesh);
+
+    // Merges positions that are equal within `tolerance` into an indexed mesh.
+    Mesh weld(const std::vector<float> &vertices, float tolerance = 1e-6f, JobSystem &jobs = core::jobs());
+
+    // Average cache miss ratio: vertex shader runs per triangle with a FIFO
+    // post-transform cache of `cacheSize` entries. 3 for unindexed meshes,
+    // approaching 0.5 for large regular grids.
+    double acmr(const Mesh &mesh, std::size_t cacheSize = 32);
+}
+
+#endif
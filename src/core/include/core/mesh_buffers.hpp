@@ -0,0 +1,50 @@
+#ifndef CORE_MESH_BUFFERS_HEADER
+#define CORE_MESH_BUFFERS_HEADER
+
+#include <glad/glad.h>
+
+#include <core/frame.hpp>
+#include <core/mesh.hpp>
+
+namespace core
+{
+    // A mesh uploaded into a vertex array: positions (three floats) at
+    // attribute 0, plus an element buffer when the mesh is indexed. Owns the
+    // GL objects, so the context has to outlive it.
+    class MeshBuffers
+    {
+    public:
+        MeshBuffers() = default;
+        explicit MeshBuffers(const mesh::Mesh &mesh);
+        ~MeshBuffers();
+
+        MeshBuffers(MeshBuffers &&other) noexcept;
+        MeshBuffers &operator=(MeshBuffers &&other) noexcept;
+
+        void bind() const;
+
+        // Draws the whole mesh, indexed when it has indices.
+        DrawCommand draw(GLenum mode = GL_TRIANGLES) const;
+
+        GLsizei vertexCount() const
+        {
+            return vertices;
+        }
+
+        GLsizei indexCount() const
+        {
+            return indices;
+        }
+
+    private:
+        void release();
+
+        GLuint vertexArrayId = 0;
+        GLuint vertexBufferId = 0;
+        GLuint indexBufferId = 0;
+        GLsizei vertices = 0;
+        GLsizei indices = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef CORE_OVERDRAW_HEADER
+#define CORE_OVERDRAW_HEADER
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <core/render_target.hpp>
+
+namespace core
+{
+    struct OverdrawStats
+    {
+        // Fragments per pixel over the whole target, and over the pixels
+        // drawn at least once.
+        double average = 0;
+        double coveredAverage = 0;
+        std::uint32_t maximum = 0;
+        // Pixels drawn 0, 1, ... times; the last bucket holds the rest.
+        std::array<std::uint64_t, 9> histogram = {};
+    };
+
+    // Fill-rate view. Between begin() and end() draws land in a float
+    // target with additive blending; together with the counting fragment
+    // shader (shaders/overdraw_fragment.glsl, see
+    // ProgramRegistry::replaceFragment) each pixel ends up holding the
+    // number of fragments shaded for it. end() reads the counts back, which
+    // waits for the GPU, and blits a heatmap into the framebuffer that was
+    // bound at begin(): black for untouched pixels, then blue, green,
+    // yellow and red for four or more fragments. Frame stats are averaged
+    // and logged every few hundred frames.
+    class Overdraw
+    {
+    public:
+        Overdraw();
+        ~Overdraw();
+
+        Overdraw(const Overdraw &) = delete;
+        Overdraw &operator=(const Overdraw &) = delete;
+
+        // Covers the current viewport; drawing must clear to zero.
+        void begin();
+        OverdrawStats end();
+
+        // Logs the averages since the previous report.
+        void report();
+
+    private:
+        void resize(int width, int height);
+
+        static constexpr std::uint64_t ReportInterval = 300;
+
+        std::unique_ptr<RenderTarget> counts;
+        GLuint heatmapFramebuffer = 0;
+        GLuint heatmapTexture = 0;
+        GLint target = 0;
+        GLint viewport[4] = {};
+        std::vector<float> values;
+        std::vector<unsigned char> colors;
+
+        std::uint64_t frames = 0;
+        OverdrawStats totals;
+    };
+}
+
+#endif
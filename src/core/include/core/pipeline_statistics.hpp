@@ -0,0 +1,52 @@
+#ifndef CORE_PIPELINE_STATISTICS_HEADER
+#define CORE_PIPELINE_STATISTICS_HEADER
+
+#include <cstdint>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace core
+{
+    struct PipelineCounts
+    {
+        std::uint64_t verticesSubmitted = 0;
+        std::uint64_t primitivesSubmitted = 0;
+        std::uint64_t vertexShaderInvocations = 0;
+        // Primitives reaching clipping, or GL_PRIMITIVES_GENERATED.
+        std::uint64_t primitives = 0;
+        std::uint64_t fragmentShaderInvocations = 0;
+        // Fallback only.
+        std::uint64_t samplesPassed = 0;
+        // False for the fallback, which leaves the vertex and fragment
+        // shader counts at 0.
+        bool exact = false;
+    };
+
+    // What the GPU did for the draws between begin() and end(), through
+    // ARB_pipeline_statistics_query. Without it, only primitives
+    // (GL_PRIMITIVES_GENERATED) and samples passed are counted; the latter
+    // matches fragment shader runs only while depth and stencil tests are
+    // off and without multisampling.
+    class PipelineStatistics
+    {
+    public:
+        PipelineStatistics();
+        ~PipelineStatistics();
+
+        PipelineStatistics(const PipelineStatistics &) = delete;
+        PipelineStatistics &operator=(const PipelineStatistics &) = delete;
+
+        void begin();
+        void end();
+
+        // Waits for the GPU when the draws have not finished yet.
+        PipelineCounts read() const;
+
+    private:
+        std::vector<GLenum> targets;
+        std::vector<GLuint> queries;
+    };
+}
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef CORE_PROFILE_HEADER
+#define CORE_PROFILE_HEADER
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#include <core/clock.hpp>
+
+// Scoped CPU zones for a timeline of where frame and startup time goes.
+//
+//     CORE_PROFILE_ZONE("upload");
+//
+// times the rest of the enclosing scope. Zones are only compiled in when the
+// core library is configured with CORE_PROFILE=ON; otherwise the macro
+// expands to nothing. Each thread appends to its own buffer without locks,
+// and writeChromeTrace() exports everything recorded so far as Chrome trace
+// JSON, which chrome://tracing and ui.perfetto.dev open directly. A zone
+// costs its two timestamp reads plus an inline append; bench_profile
+// measures both.
+//
+// The name must be a literal: only its address is stored.
+namespace core::profile
+{
+    namespace detail
+    {
+        struct Event
+        {
+            const char *name;
+            std::int64_t begin;
+            std::int64_t end;
+        };
+
+        class ThreadBuffer;
+
+        // Free space in the calling thread's current chunk. Zones append to
+        // it inline; record() registers the thread, starts the next chunk or
+        // drops the zone once it runs out.
+        struct Cursor
+        {
+            Event *next = nullptr;
+            Event *end = nullptr;
+            std::size_t count = 0;
+            // The buffer's event count, which the trace writer reads.
+            std::atomic<std::size_t> *published = nullptr;
+            ThreadBuffer *buffer = nullptr;
+        };
+
+        // Inline and constant-initialized, so reaching it is a plain
+        // thread-pointer access without a guard or wrapper call.
+        inline thread_local Cursor cursor;
+
+        void record(const char *name, std::int64_t begin, std::int64_t end);
+
+        // Ticks of the time stamp counter where there is one; converted to
+        // time against Clock when the trace is written.
+        inline std::int64_t now()
+        {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+            return static_cast<std::int64_t>(__rdtsc());
+#else
+            return Clock::now().time_since_epoch().count();
+#endif
+        }
+
+        inline void append(const char *name, std::int64_t begin, std::int64_t end)
+        {
+            Cursor &current = cursor;
+            if (current.next == current.end)
+            {
+                record(name, begin, end);
+                return;
+            }
+            *current.next++ = {name, begin, end};
+            current.published->store(++current.count, std::memory_order_release);
+        }
+    }
+
+    class Zone
+    {
+    public:
+        explicit Zone(const char *name) : name(name), begin(detail::now())
+        {
+        }
+
+        ~Zone()
+        {
+            detail::append(name, begin, detail::now());
+        }
+
+        Zone(const Zone &) = delete;
+        Zone &operator=(const Zone &) = delete;
+
+    private:
+        const char *name;
+        std::int64_t begin;
+    };
+
+    // Writes every zone recorded so far, with droppedCount() in the trace's
+    // otherData; false (with a warning) when the file cannot be written or
+    // zones are not compiled in.
+    bool writeChromeTrace(const std::string &path);
+
+    // Zones dropped because a thread buffer was full.
+    std::uint64_t droppedCount();
+}
+
+#ifdef CORE_PROFILE
+#define CORE_PROFILE_CONCAT_(a, b) a##b
+#define CORE_PROFILE_CONCAT(a, b) CORE_PROFILE_CONCAT_(a, b)
+#define CORE_PROFILE_ZONE(name) ::core::profile::Zone CORE_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define CORE_PROFILE_ZONE(name) static_cast<void>(0)
+#endif
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef CORE_PROGRAM_CACHE_HEADER
+#define CORE_PROGRAM_CACHE_HEADER
+
+#include <cstdint>
+#include <filesystem>
+
+#include <glad/glad.h>
+
+#include <shaders/embedded.hpp>
+
+namespace core
+{
+    // On-disk cache of linked program binaries.
+    //
+    // Entries are keyed by a hash of the shader sources, the format they
+    // were submitted in, their specialization constants and
+    // GL_VENDOR/GL_RENDERER/GL_VERSION, so a driver update or a different
+    // GPU simply misses. A binary the driver rejects is deleted and the
+    // caller falls back to compiling from source.
+    class ProgramCache
+    {
+    public:
+        // Needs a current context to read the driver identity.
+        explicit ProgramCache(std::filesystem::path directory = defaultDirectory());
+
+        // $XDG_CACHE_HOME/opengl-learn, falling back to ~/.cache/opengl-learn.
+        static std::filesystem::path defaultDirectory();
+
+        bool enabled() const;
+
+        // Combines the build-time source hashes with the driver identity.
+        // `spirv` says the shaders go in as their SPIR-V modules, which
+        // also get their specialization constants from the shaders.
+        std::uint64_t key(const EmbeddedShader &vertex, const EmbeddedShader &fragment, bool spirv) const;
+
+        // Returns a linked program, or 0 on a miss or an invalid entry.
+        GLuint load(std::uint64_t key) const;
+
+        // `program` must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT.
+        void store(std::uint64_t key, GLuint program) const;
+
+    private:
+        std::filesystem::path entryPath(std::uint64_t key) const;
+
+        std::filesystem::path directory;
+        std::uint64_t driver = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef CORE_PROGRAM_REGISTRY_HEADER
+#define CORE_PROGRAM_REGISTRY_HEADER
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include <shaders/embedded.hpp>
+
+#include <core/program_cache.hpp>
+#include <core/shader.hpp>
+
+namespace core
+{
+    // A linked program and its interface, reflected once at link time so
+    // lookups never reach the driver.
+    class Program
+    {
+    public:
+        GLuint id() const
+        {
+            return programId;
+        }
+
+        // -1 when the program has no such active uniform/attribute.
+        GLint uniformLocation(std::string_view name) const;
+        GLint attributeLocation(std::string_view name) const;
+
+        // GL_INVALID_INDEX when the program has no such uniform block.
+        GLuint uniformBlockIndex(std::string_view name) const;
+
+    private:
+        friend class ProgramRegistry;
+
+        using Table = std::vector<std::pair<std::string, GLint>>;
+
+        void reflect();
+
+        GLuint programId = 0;
+        Table uniforms;
+        Table attributes;
+        Table uniformBlocks;
+    };
+
+    using ProgramHandle = std::shared_ptr<const Program>;
+
+    // Interns programs by (vertex hash, fragment hash, defines) so every
+    // scene asking for the same shaders shares one compile, one link and one
+    // GL program object.
+    //
+    // The registry owns the GL objects: clear() (or destruction) deletes
+    // them, so it has to happen while the context is still current and
+    // handles must not be used afterwards.
+    class ProgramRegistry
+    {
+    public:
+        explicit ProgramRegistry(const ProgramCache *cache = nullptr);
+        ~ProgramRegistry();
+
+        ProgramRegistry(const ProgramRegistry &) = delete;
+        ProgramRegistry &operator=(const ProgramRegistry &) = delete;
+
+        // Starts compiling in the background (where the driver supports
+        // it) while the rest is set up, or loads the binary a previous run
+        // left in the program cache; acquire() picks it up later.
+        // `defines` is the permutation feature mask the variants came from.
+        void prefetch(const EmbeddedShader &vertex, const EmbeddedShader &fragment, std::uint64_t defines = 0);
+
+        // Returns the shared program, compiling it first if nobody did yet;
+        // null when it fails to build.
+        ProgramHandle acquire(const EmbeddedShader &vertex, const EmbeddedShader &fragment, std::uint64_t defines = 0);
+
+        void clear();
+
+        // Programs acquired from now on use `fragment` in place of the one
+        // asked for, for diagnostic views such as Overdraw; null restores
+        // the requested shaders.
+        void replaceFragment(const EmbeddedShader *fragment)
+        {
+            replacement = fragment;
+        }
+
+    private:
+        struct Key
+        {
+            std::uint64_t vertex;
+            std::uint64_t fragment;
+            std::uint64_t defines;
+
+            bool operator==(const Key &other) const
+            {
+                return vertex == other.vertex && fragment == other.fragment && defines == other.defines;
+            }
+        };
+
+        struct KeyHash
+        {
+            std::size_t operator()(const Key &key) const;
+        };
+
+        struct Entry
+        {
+            std::unique_ptr<PendingProgram> pending;
+            std::shared_ptr<Program> program;
+            bool failed = false;
+        };
+
+        const ProgramCache *cache;
+        const EmbeddedShader *replacement = nullptr;
+        std::unordered_map<Key, Entry, KeyHash> entries;
+    };
+}
+
+#endif
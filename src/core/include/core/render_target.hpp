@@ -0,0 +1,74 @@
+#ifndef CORE_RENDER_TARGET_HEADER
+#define CORE_RENDER_TARGET_HEADER
+
+#include <filesystem>
+
+#include <glad/glad.h>
+
+namespace core
+{
+    // A framebuffer object with a single color renderbuffer.
+    class RenderTarget
+    {
+    public:
+        RenderTarget(int width, int height, GLenum format = GL_RGBA8);
+        ~RenderTarget();
+
+        RenderTarget(const RenderTarget &) = delete;
+        RenderTarget &operator=(const RenderTarget &) = delete;
+
+        // Makes it width x height, drawn to and read from the bottom left
+        // of its storage. Storage only grows, rounded up to SizeStep pixels,
+        // so an interactive resize reallocates every few hundred pixels
+        // rather than on every event and shrinking reuses it. Returns true
+        // when it reallocated, which loses the contents.
+        bool resize(int width, int height);
+
+        // Binds it for drawing and reading and covers it with the viewport.
+        void bind() const;
+
+        GLuint framebuffer() const
+        {
+            return framebufferId;
+        }
+
+        int width() const
+        {
+            return targetWidth;
+        }
+
+        int height() const
+        {
+            return targetHeight;
+        }
+
+        // Allocated size, at least width() x height().
+        int storageWidth() const
+        {
+            return allocatedWidth;
+        }
+
+        int storageHeight() const
+        {
+            return allocatedHeight;
+        }
+
+        // Writes the color buffer as a binary PPM, top row first.
+        bool savePpm(const std::filesystem::path &path) const;
+
+    private:
+        static constexpr int SizeStep = 256;
+
+        void allocate(int width, int height);
+
+        GLuint framebufferId = 0;
+        GLuint colorId = 0;
+        GLenum format;
+        int targetWidth;
+        int targetHeight;
+        int allocatedWidth = 0;
+        int allocatedHeight = 0;
+    };
+}
+
+#endif
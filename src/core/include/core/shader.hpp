@@ -0,0 +1,79 @@
+#ifndef CORE_SHADER_HEADER
+#define CORE_SHADER_HEADER
+
+#include <cstdint>
+
+#include <glad/glad.h>
+
+#include <shaders/embedded.hpp>
+
+#include <core/clock.hpp>
+#include <core/program_cache.hpp>
+
+namespace core
+{
+    enum class ShaderFormat
+    {
+        Glsl,
+        // Prebuilt SPIR-V when the context and both shaders have it, GLSL otherwise.
+        Spirv
+    };
+
+    // A program whose compile and link were handed to the driver but not
+    // waited on.
+    //
+    // Both shaders are submitted and linked up front without any status
+    // query in between, so a driver with background compiler threads can
+    // work while the caller sets up meshes and buffers. ready() polls
+    // GL_COMPLETION_STATUS_KHR when KHR_parallel_shader_compile is present;
+    // finish() is the only call that may block, and the only one that reads
+    // link status and info logs.
+    //
+    // With a cache, a valid binary from an earlier run skips compilation
+    // entirely, and a freshly linked program is written back on finish().
+    // SPIR-V modules skip the driver's GLSL front end.
+    class PendingProgram
+    {
+    public:
+        PendingProgram(
+            const EmbeddedShader &vertex,
+            const EmbeddedShader &fragment,
+            const ProgramCache *cache = nullptr,
+            ShaderFormat format = ShaderFormat::Spirv);
+        ~PendingProgram();
+
+        PendingProgram(const PendingProgram &) = delete;
+        PendingProgram &operator=(const PendingProgram &) = delete;
+
+        // Never blocks; without the extension it cannot know and says false.
+        bool ready() const;
+
+        // Returns the linked program, or 0 after logging why it failed.
+        GLuint finish();
+
+        // What the shaders were submitted as, after any fallback.
+        ShaderFormat format() const
+        {
+            return submittedFormat;
+        }
+
+    private:
+        void reportFailure();
+
+        // Embedded shaders live for the whole run; kept for the file names
+        // in compile errors.
+        const EmbeddedShader *vertexSource;
+        const EmbeddedShader *fragmentSource;
+        GLuint vertexShaderId = 0;
+        GLuint fragmentShaderId = 0;
+        GLuint programId = 0;
+        Clock::time_point submitted;
+        ShaderFormat submittedFormat = ShaderFormat::Glsl;
+
+        const ProgramCache *cache;
+        std::uint64_t cacheKey = 0;
+        bool fromCache = false;
+    };
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef CORE_UNIFORM_RING_HEADER
+#define CORE_UNIFORM_RING_HEADER
+
+#include <cstddef>
+#include <vector>
+
+#include <glad/glad.h>
+
+namespace core
+{
+    // One uniform buffer split into `regions` equal parts used round-robin,
+    // each guarded by a fence, so a frame's blocks go in with one mapped
+    // memcpy without stalling on draws that still read an older region.
+    class UniformRing
+    {
+    public:
+        // Regions start at `regionSize` bytes and grow as frames need.
+        explicit UniformRing(std::size_t regionSize = 0, std::size_t regions = 3);
+        ~UniformRing();
+
+        UniformRing(const UniformRing &) = delete;
+        UniformRing &operator=(const UniformRing &) = delete;
+
+        GLuint buffer() const
+        {
+            return bufferId;
+        }
+
+        // GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT. Regions start at multiples of
+        // it, so blocks staged at multiples of it within a region (see
+        // FrameCommands::uniformAlignment) can be bound where they are.
+        std::size_t alignment() const
+        {
+            return offsetAlignment;
+        }
+
+        // Copies `size` bytes into the next region and returns its offset in
+        // buffer(). Grows the buffer when a frame outgrows its region.
+        GLintptr upload(const void *data, std::size_t size);
+
+        // Fences the region last uploaded to; call after the draws using it.
+        void retire();
+
+    private:
+        void allocate(std::size_t size);
+
+        GLuint bufferId = 0;
+        std::size_t offsetAlignment = 1;
+        std::size_t regionSize = 0;
+        std::size_t region = 0;
+        std::vector<GLsync> fences;
+    };
+}
+
+#endif
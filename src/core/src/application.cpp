@@ -0,0 +1,481 @@
+#include <core/application.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <core/clock.hpp>
+#include <core/gl.hpp>
+#include <core/gl_calls.hpp>
+#include <core/gl_debug.hpp>
+#include <core/log.hpp>
+#include <core/profile.hpp>
+
+#include <shaders/overdraw_fragment.generated.hpp>
+
+namespace core
+{
+    ApplicationConfig parseArguments(int argc, char **argv, ApplicationConfig defaults)
+    {
+        ApplicationConfig config = defaults;
+        for (int argument_n = 1; argument_n < argc; argument_n++)
+        {
+            const char *argument = argv[argument_n];
+            const bool hasValue = argument_n + 1 < argc;
+            if (std::strcmp(argument, "--headless") == 0)
+            {
+                config.headless = true;
+            }
+            else if (std::strcmp(argument, "--continuous") == 0)
+            {
+                config.renderOnDemand = false;
+            }
+            else if (std::strcmp(argument, "--full-redraw") == 0)
+            {
+                config.partialRedraw = false;
+            }
+            else if (std::strcmp(argument, "--frames") == 0 && hasValue)
+            {
+                config.frames = std::strtoull(argv[++argument_n], nullptr, 10);
+            }
+            else if (std::strcmp(argument, "--size") == 0 && hasValue)
+            {
+                std::sscanf(argv[++argument_n], "%dx%d", &config.width, &config.height);
+            }
+            else if (std::strcmp(argument, "--pacing") == 0 && hasValue)
+            {
+                if (!parsePacingMode(argv[++argument_n], config.pacing))
+                {
+                    log::warning("unknown pacing mode {}", argv[argument_n]);
+                }
+            }
+            else if (std::strcmp(argument, "--target-fps") == 0 && hasValue)
+            {
+                config.targetFps = std::strtod(argv[++argument_n], nullptr);
+            }
+            else if (std::strcmp(argument, "--capture") == 0 && hasValue)
+            {
+                config.capture = argv[++argument_n];
+            }
+            else if (std::strcmp(argument, "--trace") == 0 && hasValue)
+            {
+                config.trace = argv[++argument_n];
+            }
+            else if (std::strcmp(argument, "--profile-gpu") == 0)
+            {
+                config.profileGpu = true;
+            }
+            else if (std::strcmp(argument, "--gl-calls") == 0)
+            {
+                config.glCalls = true;
+            }
+            else if (std::strcmp(argument, "--gl-debug") == 0)
+            {
+                config.glDebug = true;
+            }
+            else if (std::strcmp(argument, "--overdraw") == 0)
+            {
+                config.overdraw = true;
+            }
+            else
+            {
+                log::warning("ignoring argument {}", argument);
+            }
+        }
+        if (config.headless && config.frames == 0)
+        {
+            config.frames = 300;
+        }
+        return config;
+    }
+
+    Application::Application(const ApplicationConfig &config)
+        : config(config), framebufferWidth(config.width), framebufferHeight(config.height)
+    {
+        if (config.headless)
+        {
+            {
+                CORE_PROFILE_ZONE("context init");
+                headless = std::make_unique<HeadlessContext>(config.glDebug);
+            }
+            {
+                CORE_PROFILE_ZONE("glad load");
+                if (!headless->valid() || !gladLoadGLLoader(headless->loader()))
+                {
+                    log::error("Failed to create a headless GL context");
+                    return;
+                }
+                gl::load(headless->loader());
+            }
+            if (config.glDebug)
+            {
+                gl::debug::install();
+            }
+
+            offscreen = std::make_unique<RenderTarget>(config.width, config.height);
+            offscreen->bind();
+
+            programCache = std::make_unique<ProgramCache>();
+            registry = std::make_unique<ProgramRegistry>(programCache.get());
+            uniformRing = std::make_unique<UniformRing>();
+            return;
+        }
+
+        {
+            CORE_PROFILE_ZONE("glfw init");
+            glfwInit();
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+            glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+            glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+            glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, config.glDebug ? GLFW_TRUE : GLFW_FALSE);
+
+            window = glfwCreateWindow(config.width, config.height, config.title, nullptr, nullptr);
+            if (!window)
+            {
+                log::error("Failed to create GLFW window");
+                return;
+            }
+            glfwMakeContextCurrent(window);
+        }
+
+        {
+            CORE_PROFILE_ZONE("glad load");
+            if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+            {
+                log::error("Failed to initialize GLAD");
+                return;
+            }
+            gl::load((GLADloadproc)glfwGetProcAddress);
+        }
+        if (config.glDebug)
+        {
+            gl::debug::install();
+        }
+
+        programCache = std::make_unique<ProgramCache>();
+        registry = std::make_unique<ProgramRegistry>(programCache.get());
+        uniformRing = std::make_unique<UniformRing>();
+
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        glfwSetWindowUserPointer(window, this);
+        glfwSetFramebufferSizeCallback(window, onFrameBufferSize);
+        glfwSetKeyCallback(window, onKey);
+        glfwSetWindowRefreshCallback(window, onRefresh);
+    }
+
+    Application::~Application()
+    {
+        // GL objects go while the context is still there.
+        damage.reset();
+        overdraw.reset();
+        gpuProfiler.reset();
+        uniformRing.reset();
+        registry.reset();
+        programCache.reset();
+        offscreen.reset();
+        if (headless)
+        {
+            headless.reset();
+            return;
+        }
+        if (window)
+        {
+            glfwDestroyWindow(window);
+        }
+        glfwTerminate();
+    }
+
+    bool Application::running(std::uint64_t frame) const
+    {
+        if (config.frames > 0 && frame >= config.frames)
+        {
+            return false;
+        }
+        return headless || !glfwWindowShouldClose(window);
+    }
+
+    void Application::applyResize()
+    {
+        if (!resizePending)
+        {
+            return;
+        }
+        resizePending = false;
+        resizesApplied++;
+        glViewport(0, 0, framebufferWidth, framebufferHeight);
+    }
+
+    void Application::invalidate()
+    {
+        dirty = true;
+        redrawAll = true;
+        if (window)
+        {
+            glfwPostEmptyEvent();
+        }
+    }
+
+    bool Application::idle(Scene &scene, FramePacer &pacer)
+    {
+        if (!window || !config.renderOnDemand)
+        {
+            return false;
+        }
+
+        // Frames are built ahead, so a change takes a pipeline's worth of
+        // frames to reach the screen.
+        if (dirty.exchange(false))
+        {
+            pendingFrames = config.pipelineDepth;
+        }
+        if (pendingFrames > 0 || scene.animating())
+        {
+            pendingFrames -= pendingFrames > 0;
+            return false;
+        }
+
+        CORE_PROFILE_ZONE("idle");
+        const Clock::time_point start = Clock::now();
+        const double cpuStart = processCpuSeconds();
+        glfwWaitEvents();
+        idleSeconds += millisecondsBetween(start, Clock::now()) / 1e3;
+        idleCpuSeconds += processCpuSeconds() - cpuStart;
+        skippedFrames++;
+        pacer.resume();
+        return true;
+    }
+
+    int Application::run(Scene &scene)
+    {
+        if (valid() && config.glCalls)
+        {
+            gl::calls::intercept(true);
+        }
+        if (valid() && config.overdraw)
+        {
+            registry->replaceFragment(&overdraw_fragment);
+            overdraw = std::make_unique<Overdraw>();
+        }
+
+        {
+            CORE_PROFILE_ZONE("scene setup");
+            if (!valid() || !scene.setup(*this))
+            {
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (config.profileGpu)
+        {
+            gpuProfiler = std::make_unique<GpuProfiler>();
+        }
+
+        this->scene = &scene;
+        {
+            FramePacer pacer(config.pacing, config.targetFps);
+            if (window)
+            {
+                pacer.apply();
+            }
+
+            FramePipeline<FrameCommands> pipeline(
+                config.pipelineDepth,
+                [&scene, alignment = uniformRing->alignment()](FrameCommands &frame, std::uint64_t frameIndex)
+                {
+                    frame.uniformAlignment = alignment;
+                    frame.partial = !scene.animating();
+                    frame.damage.clear();
+                    scene.build(frame, frameIndex);
+                });
+
+            const bool partialRedraw = config.partialRedraw && DamageTracker::worthwhile(window);
+            if (config.partialRedraw && !partialRedraw)
+            {
+                log::debug("partial redraw: off, neither buffer age nor swap with damage");
+            }
+
+            const Clock::time_point start = Clock::now();
+            bool waited = false;
+            while (running(pipeline.frame()))
+            {
+                if (idle(scene, pacer))
+                {
+                    waited = true;
+                    continue;
+                }
+                if (waited)
+                {
+                    pipeline.restart();
+                    waited = false;
+                }
+
+                applyResize();
+                const FrameCommands &frame = pipeline.beginFrame();
+                if (gpuProfiler)
+                {
+                    gpuProfiler->beginFrame();
+                }
+                if (overdraw)
+                {
+                    // Counts start at zero whatever the scene clears to.
+                    FrameCommands counted = frame;
+                    counted.clearColor = {.0f, .0f, .0f, .0f};
+                    overdraw->begin();
+                    submit(counted, uniformRing.get(), gpuProfiler.get());
+                    overdraw->end();
+                }
+                else
+                {
+                    // Created with the first frame reporting damage; from
+                    // then on every frame goes through its target.
+                    if (!damage && partialRedraw && frame.partial)
+                    {
+                        damage = std::make_unique<DamageTracker>(window);
+                    }
+                    const std::vector<Rect> *regions = nullptr;
+                    if (damage)
+                    {
+                        if (redrawAll.exchange(false))
+                        {
+                            damage->invalidate(config.pipelineDepth);
+                        }
+                        regions = damage->begin(frame, offscreen.get(), framebufferWidth, framebufferHeight);
+                    }
+                    submit(frame, uniformRing.get(), gpuProfiler.get(), regions);
+                }
+
+                if (window)
+                {
+                    CORE_PROFILE_ZONE("poll");
+                    glfwPollEvents();
+                }
+                {
+                    CORE_PROFILE_ZONE("pace");
+                    pacer.wait();
+                }
+                if (window)
+                {
+                    CORE_PROFILE_ZONE("swap");
+                    GpuProfiler::Zone zone(gpuProfiler.get(), "present");
+                    if (damage)
+                    {
+                        damage->present();
+                    }
+                    else
+                    {
+                        glfwSwapBuffers(window);
+                    }
+                }
+                pipeline.endFrame();
+                if (gpuProfiler)
+                {
+                    gpuProfiler->endFrame();
+                }
+                if (gl::calls::intercepting())
+                {
+                    gl::calls::endFrame();
+                }
+                if (config.glDebug)
+                {
+                    gl::debug::endFrame();
+                }
+            }
+
+            if (config.frames > 0)
+            {
+                glFinish();
+                const double milliseconds = millisecondsBetween(start, Clock::now());
+                log::info(
+                    "{} frames at {}x{} in {} ms ({} fps)",
+                    pipeline.frame(),
+                    config.width,
+                    config.height,
+                    milliseconds,
+                    pipeline.frame() * 1e3 / milliseconds);
+            }
+            if (gpuProfiler)
+            {
+                gpuProfiler->report();
+            }
+            if (config.glCalls || gl::calls::intercepting())
+            {
+                gl::calls::report();
+            }
+            if (config.glDebug)
+            {
+                gl::debug::report();
+            }
+            if (overdraw)
+            {
+                overdraw->report();
+            }
+            if (damage)
+            {
+                damage->report();
+            }
+            if (resizeEvents > 0)
+            {
+                log::info("resize: {} events applied in {} frames", resizeEvents, resizesApplied);
+            }
+            if (window && config.renderOnDemand)
+            {
+                log::info(
+                    "render on demand: {} frames drawn, {} waits without redraw, idle {} s at {}% cpu",
+                    pipeline.frame(),
+                    skippedFrames,
+                    idleSeconds,
+                    idleSeconds > 0 ? idleCpuSeconds / idleSeconds * 100 : 0);
+            }
+        }
+        this->scene = nullptr;
+
+        if (!config.trace.empty())
+        {
+            profile::writeChromeTrace(config.trace);
+        }
+        if (offscreen && !config.capture.empty() && !offscreen->savePpm(config.capture))
+        {
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // Runs inside glfwPollEvents() or glfwWaitEvents(), many times per frame
+    // during an interactive resize.
+    void Application::onFrameBufferSize(GLFWwindow *window, int width, int height)
+    {
+        if (Application *application = static_cast<Application *>(glfwGetWindowUserPointer(window)))
+        {
+            application->framebufferWidth = width;
+            application->framebufferHeight = height;
+            application->resizePending = true;
+            application->resizeEvents++;
+            application->invalidate();
+        }
+    }
+
+    void Application::onRefresh(GLFWwindow *window)
+    {
+        if (Application *application = static_cast<Application *>(glfwGetWindowUserPointer(window)))
+        {
+            application->invalidate();
+        }
+    }
+
+    void Application::onKey(GLFWwindow *window, int key, int /*scancode*/, int action, int /*mods*/)
+    {
+        log::info("Key callback: {} action: {}", key, action);
+
+        if (key == GLFW_KEY_F3 && action == GLFW_PRESS)
+        {
+            gl::calls::intercept(!gl::calls::intercepting());
+        }
+
+        Application *application = static_cast<Application *>(glfwGetWindowUserPointer(window));
+        if (application && application->scene)
+        {
+            application->scene->onKey(key, action);
+            application->invalidate();
+        }
+    }
+}
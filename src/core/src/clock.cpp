@@ -0,0 +1,22 @@
+#include <core/clock.hpp>
+
+#include <ctime>
+
+namespace core
+{
+    Clock::time_point startupTime()
+    {
+        static const Clock::time_point startup = Clock::now();
+        return startup;
+    }
+
+    double processCpuSeconds()
+    {
+        return static_cast<double>(std::clock()) / CLOCKS_PER_SEC;
+    }
+
+    namespace
+    {
+        const Clock::time_point captureAtLoad = startupTime();
+    }
+}
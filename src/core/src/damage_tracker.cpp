@@ -0,0 +1,318 @@
+#include <core/damage_tracker.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef CORE_HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#define GLFW_EXPOSE_NATIVE_EGL
+#include <GLFW/glfw3native.h>
+#endif
+
+#include <core/gl.hpp>
+#include <core/log.hpp>
+#include <core/profile.hpp>
+
+namespace core
+{
+    namespace
+    {
+        // Past this share of the target one scissored pass over the whole
+        // of it is cheaper than several overlapping ones.
+        constexpr double WholeFrameShare = .5;
+
+        bool overlap(const Rect &a, const Rect &b)
+        {
+            return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+        }
+
+        Rect merge(const Rect &a, const Rect &b)
+        {
+            const int left = std::min(a.x, b.x);
+            const int bottom = std::min(a.y, b.y);
+            const int right = std::max(a.x + a.width, b.x + b.width);
+            const int top = std::max(a.y + a.height, b.y + b.height);
+            return {left, bottom, right - left, top - bottom};
+        }
+
+        // Merges overlapping or touching rectangles until none are left, so
+        // no pixel is drawn twice.
+        void coalesce(std::vector<Rect> &rects)
+        {
+            for (std::size_t rect_n = 0; rect_n < rects.size(); rect_n++)
+            {
+                for (std::size_t other_n = rect_n + 1; other_n < rects.size(); other_n++)
+                {
+                    if (overlap(rects[rect_n], rects[other_n]))
+                    {
+                        rects[rect_n] = merge(rects[rect_n], rects[other_n]);
+                        rects.erase(rects.begin() + other_n);
+                        other_n = rect_n;
+                    }
+                }
+            }
+        }
+
+        double area(const std::vector<Rect> &rects)
+        {
+            double pixels = 0;
+            for (const Rect &rect : rects)
+            {
+                pixels += static_cast<double>(rect.width) * rect.height;
+            }
+            return pixels;
+        }
+
+        struct WindowSupport
+        {
+            void *display = nullptr;
+            void *surface = nullptr;
+            void *swapWithDamage = nullptr;
+            bool queryAge = false;
+        };
+
+        WindowSupport windowSupport(GLFWwindow *window)
+        {
+            WindowSupport support;
+            if (!window)
+            {
+                return support;
+            }
+#ifdef CORE_HAVE_EGL
+            if (glfwGetWindowAttrib(window, GLFW_CONTEXT_CREATION_API) == GLFW_EGL_CONTEXT_API)
+            {
+                support.display = glfwGetEGLDisplay();
+                support.surface = glfwGetEGLSurface(window);
+                const char *extensions = eglQueryString(support.display, EGL_EXTENSIONS);
+                if (gl::hasExtension(extensions, "EGL_KHR_swap_buffers_with_damage"))
+                {
+                    support.swapWithDamage = reinterpret_cast<void *>(eglGetProcAddress("eglSwapBuffersWithDamageKHR"));
+                }
+                else if (gl::hasExtension(extensions, "EGL_EXT_swap_buffers_with_damage"))
+                {
+                    support.swapWithDamage = reinterpret_cast<void *>(eglGetProcAddress("eglSwapBuffersWithDamageEXT"));
+                }
+                support.queryAge = gl::hasExtension(extensions, "EGL_EXT_buffer_age") || gl::hasExtension(extensions, "EGL_KHR_partial_update");
+            }
+#endif
+            return support;
+        }
+    }
+
+    bool DamageTracker::worthwhile(GLFWwindow *window)
+    {
+        const WindowSupport support = windowSupport(window);
+        return !window || support.swapWithDamage || support.queryAge;
+    }
+
+    DamageTracker::DamageTracker(GLFWwindow *window) : window(window)
+    {
+        const WindowSupport support = windowSupport(window);
+        display = support.display;
+        surface = support.surface;
+        swapWithDamage = support.swapWithDamage;
+        queryAge = support.queryAge;
+        if (window)
+        {
+            log::debug(
+                "partial redraw: swap with damage {}, buffer age {}",
+                swapWithDamage ? "yes" : "no",
+                queryAge ? "yes" : "no");
+        }
+    }
+
+    void DamageTracker::invalidate(std::size_t frames)
+    {
+        wholeFrames = std::max(wholeFrames, frames);
+    }
+
+    const std::vector<Rect> *DamageTracker::begin(const FrameCommands &frame, RenderTarget *offscreen, int width, int height)
+    {
+        RenderTarget *target = offscreen;
+        if (window)
+        {
+            if (!back)
+            {
+                back = std::make_unique<RenderTarget>(width, height);
+            }
+            else if (back->width() != width || back->height() != height)
+            {
+                back->resize(width, height);
+            }
+            target = back.get();
+        }
+        target->bind();
+
+        // A new or resized target holds nothing worth keeping, even where
+        // it kept its storage.
+        if (target->framebuffer() != framebuffer || target->width() != this->width || target->height() != this->height)
+        {
+            framebuffer = target->framebuffer();
+            this->width = target->width();
+            this->height = target->height();
+            wholeFrames = std::max<std::size_t>(wholeFrames, 1);
+            history.clear();
+        }
+
+        whole = wholeFrames > 0 || !frame.partial;
+        if (wholeFrames > 0)
+        {
+            wholeFrames--;
+        }
+        regions.clear();
+        if (!whole)
+        {
+            regionsOf(frame, this->width, this->height);
+        }
+
+        const double pixels = static_cast<double>(this->width) * this->height;
+        frames++;
+        wholeFrameCount += whole;
+        drawnPixels += whole ? pixels : area(regions);
+        totalPixels += pixels;
+
+        history.push_back(whole ? std::vector<Rect>{{0, 0, this->width, this->height}} : regions);
+        if (history.size() > MaxBufferAge)
+        {
+            history.pop_front();
+        }
+
+        if (!window && frames % ReportInterval == 0)
+        {
+            report();
+        }
+        return whole ? nullptr : &regions;
+    }
+
+    void DamageTracker::regionsOf(const FrameCommands &frame, int width, int height)
+    {
+        for (const mesh::Bounds &bounds : frame.damage)
+        {
+            // A pixel of margin for rasterization rounding at the edges.
+            const int left = std::max(static_cast<int>(std::floor((bounds.left + 1) * .5f * width)) - 1, 0);
+            const int bottom = std::max(static_cast<int>(std::floor((bounds.bottom + 1) * .5f * height)) - 1, 0);
+            const int right = std::min(static_cast<int>(std::ceil((bounds.right + 1) * .5f * width)) + 1, width);
+            const int top = std::min(static_cast<int>(std::ceil((bounds.top + 1) * .5f * height)) + 1, height);
+            if (left < right && bottom < top)
+            {
+                regions.push_back({left, bottom, right - left, top - bottom});
+            }
+        }
+        coalesce(regions);
+
+        if (area(regions) > WholeFrameShare * width * height)
+        {
+            regions.clear();
+            whole = true;
+        }
+    }
+
+    int DamageTracker::bufferAge() const
+    {
+#ifdef CORE_HAVE_EGL
+        EGLint age = 0;
+        if (queryAge && eglQuerySurface(display, surface, EGL_BUFFER_AGE_EXT, &age))
+        {
+            return age;
+        }
+#endif
+        return 0;
+    }
+
+    void DamageTracker::present()
+    {
+        {
+            CORE_PROFILE_ZONE("blit");
+            // The window's buffer holds the frame `age` frames back (0 when
+            // unknown), so it misses the damage of the frames since.
+            const int age = bufferAge();
+            copies.clear();
+            if (age <= 0 || static_cast<std::size_t>(age) > history.size())
+            {
+                copies.push_back({0, 0, width, height});
+            }
+            else
+            {
+                for (std::size_t frame_n = history.size() - age; frame_n < history.size(); frame_n++)
+                {
+                    copies.insert(copies.end(), history[frame_n].begin(), history[frame_n].end());
+                }
+                coalesce(copies);
+            }
+            copiedPixels += area(copies);
+
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, back->framebuffer());
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+            for (const Rect &copy : copies)
+            {
+                glBlitFramebuffer(
+                    copy.x,
+                    copy.y,
+                    copy.x + copy.width,
+                    copy.y + copy.height,
+                    copy.x,
+                    copy.y,
+                    copy.x + copy.width,
+                    copy.y + copy.height,
+                    GL_COLOR_BUFFER_BIT,
+                    GL_NEAREST);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
+
+#ifdef CORE_HAVE_EGL
+        if (swapWithDamage)
+        {
+            // No rectangles stand for the whole surface, so a frame where
+            // nothing changed reports a single pixel.
+            std::vector<EGLint> rects;
+            for (const Rect &region : regions)
+            {
+                rects.insert(rects.end(), {region.x, region.y, region.width, region.height});
+            }
+            if (!whole && rects.empty())
+            {
+                rects = {0, 0, 1, 1};
+            }
+            auto swap = reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC>(swapWithDamage);
+            swap(display, surface, rects.data(), static_cast<EGLint>(rects.size() / 4));
+        }
+        else
+#endif
+        {
+            glfwSwapBuffers(window);
+        }
+
+        if (frames % ReportInterval == 0)
+        {
+            report();
+        }
+    }
+
+    void DamageTracker::report()
+    {
+        if (totalPixels == 0)
+        {
+            return;
+        }
+        if (window)
+        {
+            log::info(
+                "partial redraw: {}% of pixels drawn, {}% copied to the window, {} of {} frames whole",
+                drawnPixels / totalPixels * 100,
+                copiedPixels / totalPixels * 100,
+                wholeFrameCount,
+                frames);
+        }
+        else
+        {
+            log::info("partial redraw: {}% of pixels drawn, {} of {} frames whole", drawnPixels / totalPixels * 100, wholeFrameCount, frames);
+        }
+        frames = 0;
+        wholeFrameCount = 0;
+        drawnPixels = 0;
+        copiedPixels = 0;
+        totalPixels = 0;
+    }
+}
@@ -0,0 +1,155 @@
+#include <core/frame.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+#include <core/clock.hpp>
+#include <core/log.hpp>
+#include <core/profile.hpp>
+
+namespace core
+{
+    namespace
+    {
+        GLsizei indexSize(GLenum indexType)
+        {
+            switch (indexType)
+            {
+            case GL_UNSIGNED_BYTE:
+                return 1;
+            case GL_UNSIGNED_SHORT:
+                return 2;
+            default:
+                return 4;
+            }
+        }
+
+        double seconds(FramePipelineStats::Clock::duration duration)
+        {
+            return std::chrono::duration<double>(duration).count();
+        }
+    }
+
+    void submit(const FrameCommands &frame, UniformRing *ring, GpuProfiler *profiler, const std::vector<Rect> *regions)
+    {
+        if (regions && regions->empty())
+        {
+            return;
+        }
+
+        const bool uniforms = ring && !frame.uniforms.empty();
+        const GLintptr base = uniforms ? ring->upload(frame.uniforms.data(), frame.uniforms.size()) : 0;
+        auto bind = [&](const UniformRange &range)
+        {
+            if (uniforms && range.size > 0)
+            {
+                glBindBufferRange(GL_UNIFORM_BUFFER, range.binding, ring->buffer(), base + range.offset, range.size);
+            }
+        };
+
+        for (const UniformRange &range : frame.uniformBindings)
+        {
+            bind(range);
+        }
+
+        if (regions)
+        {
+            glEnable(GL_SCISSOR_TEST);
+        }
+        const std::size_t passes = regions ? regions->size() : 1;
+        for (std::size_t pass_n = 0; pass_n < passes; pass_n++)
+        {
+            if (regions)
+            {
+                const Rect &region = (*regions)[pass_n];
+                glScissor(region.x, region.y, region.width, region.height);
+            }
+            {
+                CORE_PROFILE_ZONE("clear");
+                GpuProfiler::Zone zone(profiler, "clear");
+                glClearColor(frame.clearColor[0], frame.clearColor[1], frame.clearColor[2], frame.clearColor[3]);
+                glClear(GL_COLOR_BUFFER_BIT);
+            }
+
+            // Not known on entry, so the first draw naming one binds it.
+            GLuint vertexArray = 0;
+            for (const DrawCommand &draw : frame.draws)
+            {
+                if (draw.vertexArray && draw.vertexArray != vertexArray)
+                {
+                    glBindVertexArray(draw.vertexArray);
+                    vertexArray = draw.vertexArray;
+                }
+                bind(draw.uniforms);
+                CORE_PROFILE_ZONE("draw");
+                GpuProfiler::Zone zone(profiler, draw.label);
+                if (draw.indexType == GL_NONE)
+                {
+                    glDrawArrays(draw.mode, draw.first, draw.count);
+                }
+                else
+                {
+                    const std::uintptr_t offset = draw.first * indexSize(draw.indexType);
+                    glDrawElements(draw.mode, draw.count, draw.indexType, reinterpret_cast<const void *>(offset));
+                }
+            }
+        }
+        if (regions)
+        {
+            glDisable(GL_SCISSOR_TEST);
+        }
+
+        if (uniforms)
+        {
+            ring->retire();
+        }
+    }
+
+    void FramePipelineStats::record(
+        Clock::duration build,
+        Clock::duration stall,
+        Clock::duration gpuWait,
+        Clock::duration latency)
+    {
+        if (!presentedFirstFrame)
+        {
+            presentedFirstFrame = true;
+            log::info("first frame presented {} ms after startup", millisecondsSinceStartup());
+        }
+
+        frames++;
+        buildSeconds += seconds(build);
+        stallSeconds += seconds(stall);
+        gpuWaitSeconds += seconds(gpuWait);
+        latencySeconds += seconds(latency);
+        maxLatencySeconds = std::max(maxLatencySeconds, seconds(latency));
+
+        if (frames == ReportInterval)
+        {
+            report();
+        }
+    }
+
+    void FramePipelineStats::report()
+    {
+        // Build time the GL thread did not have to wait for ran in parallel with submit/present.
+        const double overlap = buildSeconds > 0 ? std::max(buildSeconds - stallSeconds, .0) / buildSeconds : 1.0;
+
+        log::info(
+            "frame pipeline depth {}: latency avg {} ms max {} ms, build {} ms, overlap {}%, cpu stall {} ms, gpu wait {} ms",
+            depth,
+            latencySeconds / frames * 1e3,
+            maxLatencySeconds * 1e3,
+            buildSeconds / frames * 1e3,
+            overlap * 100,
+            stallSeconds / frames * 1e3,
+            gpuWaitSeconds / frames * 1e3);
+
+        frames = 0;
+        buildSeconds = 0;
+        stallSeconds = 0;
+        gpuWaitSeconds = 0;
+        latencySeconds = 0;
+        maxLatencySeconds = 0;
+    }
+}
@@ -0,0 +1,177 @@
+#include <core/frame_pacer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <utility>
+
+#include <GLFW/glfw3.h>
+
+#include <core/log.hpp>
+
+namespace core
+{
+    namespace
+    {
+        // Sleeping stops this far before the deadline; the rest is spun.
+        constexpr auto SpinMargin = std::chrono::microseconds(1500);
+    }
+
+    bool parsePacingMode(const char *name, PacingMode &mode)
+    {
+        const std::pair<const char *, PacingMode> modes[] = {
+            {"vsync", PacingMode::Vsync},
+            {"off", PacingMode::Uncapped},
+            {"adaptive", PacingMode::Adaptive},
+            {"limit", PacingMode::Limited}};
+        for (const auto &[modeName, value] : modes)
+        {
+            if (std::strcmp(name, modeName) == 0)
+            {
+                mode = value;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char *pacingModeName(PacingMode mode)
+    {
+        switch (mode)
+        {
+        case PacingMode::Vsync:
+            return "vsync";
+        case PacingMode::Uncapped:
+            return "off";
+        case PacingMode::Adaptive:
+            return "adaptive";
+        case PacingMode::Limited:
+            return "limit";
+        }
+        return "?";
+    }
+
+    FramePacer::FramePacer(PacingMode mode, double targetFps)
+        : pacingMode(mode),
+          period(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(targetFps, 1.0))))
+    {
+        intervals.reserve(ReportInterval);
+    }
+
+    void FramePacer::apply()
+    {
+        if (pacingMode == PacingMode::Adaptive &&
+            !glfwExtensionSupported("GLX_EXT_swap_control_tear") &&
+            !glfwExtensionSupported("WGL_EXT_swap_control_tear"))
+        {
+            log::warning("adaptive vsync needs EXT_swap_control_tear, using vsync");
+            pacingMode = PacingMode::Vsync;
+        }
+
+        switch (pacingMode)
+        {
+        case PacingMode::Vsync:
+            glfwSwapInterval(1);
+            break;
+        case PacingMode::Adaptive:
+            glfwSwapInterval(-1);
+            break;
+        case PacingMode::Uncapped:
+        case PacingMode::Limited:
+            glfwSwapInterval(0);
+            break;
+        }
+        log::debug("frame pacing: {}", pacingModeName(pacingMode));
+    }
+
+    void FramePacer::wait()
+    {
+        if (pacingMode == PacingMode::Limited)
+        {
+            Clock::time_point now = Clock::now();
+            // After a stall, start over instead of rushing to catch up.
+            if (deadline == Clock::time_point{} || now - deadline > period)
+            {
+                if (deadline != Clock::time_point{})
+                {
+                    lateFrames++;
+                }
+                deadline = now;
+            }
+            if (deadline - now > SpinMargin)
+            {
+                std::this_thread::sleep_until(deadline - SpinMargin);
+            }
+            while (Clock::now() < deadline)
+            {
+            }
+            deadline += period;
+        }
+
+        const Clock::time_point now = Clock::now();
+        if (previous != Clock::time_point{})
+        {
+            intervals.push_back(millisecondsBetween(previous, now));
+        }
+        else
+        {
+            windowStart = now;
+            windowCpuStart = processCpuSeconds();
+        }
+        previous = now;
+
+        if (intervals.size() == ReportInterval)
+        {
+            report();
+        }
+    }
+
+    void FramePacer::resume()
+    {
+        previous = {};
+        deadline = {};
+    }
+
+    void FramePacer::report()
+    {
+        double sum = 0;
+        for (double interval : intervals)
+        {
+            sum += interval;
+        }
+        const double mean = sum / intervals.size();
+        double variance = 0;
+        for (double interval : intervals)
+        {
+            variance += (interval - mean) * (interval - mean);
+        }
+
+        std::vector<double> deviations;
+        deviations.reserve(intervals.size());
+        for (double interval : intervals)
+        {
+            deviations.push_back(std::abs(interval - mean));
+        }
+        std::sort(deviations.begin(), deviations.end());
+
+        const Clock::time_point now = Clock::now();
+        const double cpu = processCpuSeconds();
+        const double wall = millisecondsBetween(windowStart, now) / 1e3;
+
+        log::info(
+            "frame pacing {}: interval {} ms, jitter {} ms stddev, {} ms p99, {} ms max, {} late, cpu {}%",
+            pacingModeName(pacingMode),
+            mean,
+            std::sqrt(variance / intervals.size()),
+            deviations[static_cast<std::size_t>(.99 * (deviations.size() - 1))],
+            deviations.back(),
+            lateFrames,
+            wall > 0 ? (cpu - windowCpuStart) / wall * 100 : 0);
+
+        intervals.clear();
+        lateFrames = 0;
+        windowStart = now;
+        windowCpuStart = cpu;
+    }
+}
@@ -0,0 +1,121 @@
+#include <core/gl.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <core/log.hpp>
+
+namespace core::gl
+{
+    namespace
+    {
+        Extensions supported;
+        std::vector<std::string> names;
+
+        bool atLeast(int major, int minor)
+        {
+            return GLVersion.major > major || (GLVersion.major == major && GLVersion.minor >= minor);
+        }
+
+        template <typename Proc>
+        Proc resolve(GLADloadproc loader, const char *name)
+        {
+            return reinterpret_cast<Proc>(loader(name));
+        }
+    }
+
+    PFNGLMAXSHADERCOMPILERTHREADSKHRPROC maxShaderCompilerThreads = nullptr;
+    PFNGLGETPROGRAMBINARYPROC getProgramBinary = nullptr;
+    PFNGLPROGRAMBINARYPROC programBinary = nullptr;
+    PFNGLPROGRAMPARAMETERIPROC programParameteri = nullptr;
+    PFNGLSHADERBINARYPROC shaderBinary = nullptr;
+    PFNGLSPECIALIZESHADERPROC specializeShader = nullptr;
+    PFNGLDEBUGMESSAGECALLBACKPROC debugMessageCallback = nullptr;
+    PFNGLDEBUGMESSAGECONTROLPROC debugMessageControl = nullptr;
+
+    void load(GLADloadproc loader)
+    {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        names.clear();
+        for (GLint extension_n = 0; extension_n < count; extension_n++)
+        {
+            names.emplace_back(reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, extension_n)));
+        }
+        std::sort(names.begin(), names.end());
+
+        if (supports("GL_KHR_parallel_shader_compile") || supports("GL_ARB_parallel_shader_compile"))
+        {
+            maxShaderCompilerThreads = resolve<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(loader, "glMaxShaderCompilerThreadsKHR");
+            if (!maxShaderCompilerThreads)
+            {
+                maxShaderCompilerThreads = resolve<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(loader, "glMaxShaderCompilerThreadsARB");
+            }
+            supported.parallelShaderCompile = maxShaderCompilerThreads != nullptr;
+        }
+
+        if (atLeast(4, 1) || supports("GL_ARB_get_program_binary"))
+        {
+            getProgramBinary = resolve<PFNGLGETPROGRAMBINARYPROC>(loader, "glGetProgramBinary");
+            programBinary = resolve<PFNGLPROGRAMBINARYPROC>(loader, "glProgramBinary");
+            programParameteri = resolve<PFNGLPROGRAMPARAMETERIPROC>(loader, "glProgramParameteri");
+
+            GLint formats = 0;
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+            supported.programBinary = getProgramBinary && programBinary && programParameteri && formats > 0;
+        }
+
+        if (atLeast(4, 6) || supports("GL_ARB_gl_spirv"))
+        {
+            shaderBinary = resolve<PFNGLSHADERBINARYPROC>(loader, "glShaderBinary");
+            specializeShader = resolve<PFNGLSPECIALIZESHADERPROC>(loader, atLeast(4, 6) ? "glSpecializeShader" : "glSpecializeShaderARB");
+            supported.spirv = shaderBinary && specializeShader;
+        }
+
+        if (atLeast(4, 3) || supports("GL_KHR_debug"))
+        {
+            // Core and KHR_debug on desktop GL share the unsuffixed names.
+            debugMessageCallback = resolve<PFNGLDEBUGMESSAGECALLBACKPROC>(loader, "glDebugMessageCallback");
+            debugMessageControl = resolve<PFNGLDEBUGMESSAGECONTROLPROC>(loader, "glDebugMessageControl");
+            supported.debug = debugMessageCallback && debugMessageControl;
+        }
+
+        supported.pipelineStatistics = atLeast(4, 6) || supports("GL_ARB_pipeline_statistics_query");
+
+        log::debug(
+            "GL {}.{}: {} extensions, parallel shader compile {}, program binary {}, spir-v {}, debug {}, pipeline statistics {}",
+            GLVersion.major,
+            GLVersion.minor,
+            count,
+            supported.parallelShaderCompile,
+            supported.programBinary,
+            supported.spirv,
+            supported.debug,
+            supported.pipelineStatistics);
+    }
+
+    const Extensions &extensions()
+    {
+        return supported;
+    }
+
+    bool supports(std::string_view extension)
+    {
+        return std::binary_search(names.begin(), names.end(), extension, [](std::string_view a, std::string_view b) { return a < b; });
+    }
+
+    bool hasExtension(const char *extensions, const char *name)
+    {
+        const std::size_t length = std::strlen(name);
+        for (const char *found = extensions ? std::strstr(extensions, name) : nullptr; found; found = std::strstr(found + length, name))
+        {
+            if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0'))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,375 @@
+#include <core/gl_calls.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include <glad/glad.h>
+
+#include <core/clock.hpp>
+#include <core/log.hpp>
+
+// Entry points without a byte count, then those with one.
+#define CORE_GL_CALLS(X)               \
+    X(glActiveTexture)                 \
+    X(glAttachShader)                  \
+    X(glBeginQuery)                    \
+    X(glBindBuffer)                    \
+    X(glBindBufferBase)                \
+    X(glBindBufferRange)               \
+    X(glBindFramebuffer)               \
+    X(glBindRenderbuffer)              \
+    X(glBindTexture)                   \
+    X(glBindVertexArray)               \
+    X(glBlendFunc)                     \
+    X(glBlitFramebuffer)               \
+    X(glCheckFramebufferStatus)        \
+    X(glClear)                         \
+    X(glClearColor)                    \
+    X(glClientWaitSync)                \
+    X(glCompileShader)                 \
+    X(glCreateProgram)                 \
+    X(glCreateShader)                  \
+    X(glDeleteBuffers)                 \
+    X(glDeleteFramebuffers)            \
+    X(glDeleteProgram)                 \
+    X(glDeleteQueries)                 \
+    X(glDeleteRenderbuffers)           \
+    X(glDeleteShader)                  \
+    X(glDeleteSync)                    \
+    X(glDeleteTextures)                \
+    X(glDeleteVertexArrays)            \
+    X(glDetachShader)                  \
+    X(glDisable)                       \
+    X(glDrawArrays)                    \
+    X(glDrawArraysInstanced)           \
+    X(glDrawElements)                  \
+    X(glDrawElementsInstanced)         \
+    X(glEnable)                        \
+    X(glEnableVertexAttribArray)       \
+    X(glEndQuery)                      \
+    X(glFenceSync)                     \
+    X(glFinish)                        \
+    X(glFlush)                         \
+    X(glFramebufferRenderbuffer)       \
+    X(glFramebufferTexture2D)          \
+    X(glGenBuffers)                    \
+    X(glGenFramebuffers)               \
+    X(glGenQueries)                    \
+    X(glGenRenderbuffers)              \
+    X(glGenTextures)                   \
+    X(glGenVertexArrays)               \
+    X(glGetActiveAttrib)               \
+    X(glGetActiveUniform)              \
+    X(glGetActiveUniformBlockName)     \
+    X(glGetAttribLocation)             \
+    X(glGetError)                      \
+    X(glGetIntegerv)                   \
+    X(glGetProgramInfoLog)             \
+    X(glGetProgramiv)                  \
+    X(glGetQueryObjectiv)              \
+    X(glGetQueryObjectui64v)           \
+    X(glGetShaderInfoLog)              \
+    X(glGetShaderiv)                   \
+    X(glGetString)                     \
+    X(glGetStringi)                    \
+    X(glGetUniformBlockIndex)          \
+    X(glGetUniformLocation)            \
+    X(glLinkProgram)                   \
+    X(glPixelStorei)                   \
+    X(glPolygonMode)                   \
+    X(glQueryCounter)                  \
+    X(glReadPixels)                    \
+    X(glRenderbufferStorage)           \
+    X(glScissor)                       \
+    X(glShaderSource)                  \
+    X(glTexParameteri)                 \
+    X(glUniform1f)                     \
+    X(glUniform1i)                     \
+    X(glUniform4f)                     \
+    X(glUniformBlockBinding)           \
+    X(glUniformMatrix4fv)              \
+    X(glUnmapBuffer)                   \
+    X(glUseProgram)                    \
+    X(glVertexAttribPointer)           \
+    X(glViewport)
+
+#define CORE_GL_UPLOADS(X)                   \
+    X(glBufferData, bufferDataBytes)         \
+    X(glBufferSubData, bufferSubDataBytes)   \
+    X(glMapBufferRange, mapBufferRangeBytes) \
+    X(glTexImage1D, texImage1DBytes)         \
+    X(glTexImage2D, texImage2DBytes)         \
+    X(glTexImage3D, texImage3DBytes)         \
+    X(glTexSubImage2D, texSubImage2DBytes)   \
+    X(glTexSubImage3D, texSubImage3DBytes)
+
+namespace core::gl::calls
+{
+    namespace
+    {
+        enum Index : std::size_t
+        {
+#define CORE_GL_INDEX(name) name##Index,
+#define CORE_GL_UPLOAD_INDEX(name, bytes) name##Index,
+            CORE_GL_CALLS(CORE_GL_INDEX)
+            CORE_GL_UPLOADS(CORE_GL_UPLOAD_INDEX)
+#undef CORE_GL_INDEX
+#undef CORE_GL_UPLOAD_INDEX
+            EntryCount
+        };
+
+        const char *const Names[EntryCount] = {
+#define CORE_GL_NAME(name) #name,
+#define CORE_GL_UPLOAD_NAME(name, bytes) #name,
+            CORE_GL_CALLS(CORE_GL_NAME)
+            CORE_GL_UPLOADS(CORE_GL_UPLOAD_NAME)
+#undef CORE_GL_NAME
+#undef CORE_GL_UPLOAD_NAME
+        };
+
+        constexpr std::uint64_t ReportInterval = 300;
+
+        bool enabled = false;
+        Counters totals[EntryCount];
+        Counters frame;
+        Counters window;
+        std::uint64_t frames = 0;
+
+        // Ignores GL_UNPACK_ALIGNMENT and row lengths; close enough to see
+        // where upload bandwidth goes.
+        std::uint64_t pixelBytes(GLenum format, GLenum type)
+        {
+            switch (type)
+            {
+            case GL_UNSIGNED_BYTE_3_3_2:
+            case GL_UNSIGNED_BYTE_2_3_3_REV:
+                return 1;
+            case GL_UNSIGNED_SHORT_5_6_5:
+            case GL_UNSIGNED_SHORT_5_6_5_REV:
+            case GL_UNSIGNED_SHORT_4_4_4_4:
+            case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+            case GL_UNSIGNED_SHORT_5_5_5_1:
+            case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+                return 2;
+            case GL_UNSIGNED_INT_8_8_8_8:
+            case GL_UNSIGNED_INT_8_8_8_8_REV:
+            case GL_UNSIGNED_INT_10_10_10_2:
+            case GL_UNSIGNED_INT_2_10_10_10_REV:
+            case GL_UNSIGNED_INT_24_8:
+            case GL_UNSIGNED_INT_10F_11F_11F_REV:
+            case GL_UNSIGNED_INT_5_9_9_9_REV:
+                return 4;
+            case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+                return 8;
+            }
+
+            std::uint64_t components = 4;
+            switch (format)
+            {
+            case GL_RED:
+            case GL_RED_INTEGER:
+            case GL_DEPTH_COMPONENT:
+            case GL_STENCIL_INDEX:
+                components = 1;
+                break;
+            case GL_RG:
+            case GL_RG_INTEGER:
+                components = 2;
+                break;
+            case GL_RGB:
+            case GL_BGR:
+            case GL_RGB_INTEGER:
+            case GL_BGR_INTEGER:
+                components = 3;
+                break;
+            }
+
+            switch (type)
+            {
+            case GL_SHORT:
+            case GL_UNSIGNED_SHORT:
+            case GL_HALF_FLOAT:
+                return components * 2;
+            case GL_INT:
+            case GL_UNSIGNED_INT:
+            case GL_FLOAT:
+                return components * 4;
+            default:
+                return components;
+            }
+        }
+
+        std::uint64_t texelBytes(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels)
+        {
+            // A null pointer only allocates (or reads from a bound unpack buffer).
+            return pixels ? static_cast<std::uint64_t>(width) * height * depth * pixelBytes(format, type) : 0;
+        }
+
+        std::uint64_t bufferDataBytes(GLenum, GLsizeiptr size, const void *data, GLenum)
+        {
+            return data ? static_cast<std::uint64_t>(size) : 0;
+        }
+
+        std::uint64_t bufferSubDataBytes(GLenum, GLintptr, GLsizeiptr size, const void *)
+        {
+            return static_cast<std::uint64_t>(size);
+        }
+
+        std::uint64_t mapBufferRangeBytes(GLenum, GLintptr, GLsizeiptr length, GLbitfield access)
+        {
+            return access & GL_MAP_WRITE_BIT ? static_cast<std::uint64_t>(length) : 0;
+        }
+
+        std::uint64_t texImage1DBytes(GLenum, GLint, GLint, GLsizei width, GLint, GLenum format, GLenum type, const void *pixels)
+        {
+            return texelBytes(width, 1, 1, format, type, pixels);
+        }
+
+        std::uint64_t texImage2DBytes(GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum format, GLenum type, const void *pixels)
+        {
+            return texelBytes(width, height, 1, format, type, pixels);
+        }
+
+        std::uint64_t texImage3DBytes(
+            GLenum, GLint, GLint, GLsizei width, GLsizei height, GLsizei depth, GLint, GLenum format, GLenum type, const void *pixels)
+        {
+            return texelBytes(width, height, depth, format, type, pixels);
+        }
+
+        std::uint64_t texSubImage2DBytes(GLenum, GLint, GLint, GLint, GLsizei width, GLsizei height, GLenum format, GLenum type, const void *pixels)
+        {
+            return texelBytes(width, height, 1, format, type, pixels);
+        }
+
+        std::uint64_t texSubImage3DBytes(
+            GLenum, GLint, GLint, GLint, GLint, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void *pixels)
+        {
+            return texelBytes(width, height, depth, format, type, pixels);
+        }
+
+        void record(std::size_t index, Clock::time_point start, std::uint64_t bytes)
+        {
+            const std::uint64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            for (Counters *counters : {&totals[index], &frame})
+            {
+                counters->calls++;
+                counters->nanoseconds += nanoseconds;
+                counters->bytes += bytes;
+            }
+        }
+
+        template <std::size_t Index, auto Bytes, typename Proc>
+        struct Wrapper;
+
+        template <std::size_t Index, auto Bytes, typename Result, typename... Args>
+        struct Wrapper<Index, Bytes, Result(APIENTRYP)(Args...)>
+        {
+            static inline Result(APIENTRYP original)(Args...) = nullptr;
+
+            static Result APIENTRY call(Args... args)
+            {
+                std::uint64_t bytes = 0;
+                if constexpr (!std::is_null_pointer_v<decltype(Bytes)>)
+                {
+                    bytes = Bytes(args...);
+                }
+
+                const Clock::time_point start = Clock::now();
+                if constexpr (std::is_void_v<Result>)
+                {
+                    original(args...);
+                    record(Index, start, bytes);
+                }
+                else
+                {
+                    Result result = original(args...);
+                    record(Index, start, bytes);
+                    return result;
+                }
+            }
+        };
+
+        template <std::size_t Index, auto Bytes = nullptr, typename Proc>
+        void swap(Proc &slot, bool enable)
+        {
+            using Entry = Wrapper<Index, Bytes, Proc>;
+            if (enable && slot && slot != &Entry::call)
+            {
+                Entry::original = slot;
+                slot = &Entry::call;
+            }
+            else if (!enable && slot == &Entry::call)
+            {
+                slot = Entry::original;
+            }
+        }
+    }
+
+    void intercept(bool enable)
+    {
+        if (enable == enabled)
+        {
+            return;
+        }
+#define CORE_GL_SWAP(name) swap<name##Index>(name, enable);
+#define CORE_GL_SWAP_UPLOAD(name, bytes) swap<name##Index, bytes>(name, enable);
+        CORE_GL_CALLS(CORE_GL_SWAP)
+        CORE_GL_UPLOADS(CORE_GL_SWAP_UPLOAD)
+#undef CORE_GL_SWAP
+#undef CORE_GL_SWAP_UPLOAD
+        enabled = enable;
+        log::info("GL call interception {}", enable ? "on" : "off");
+    }
+
+    bool intercepting()
+    {
+        return enabled;
+    }
+
+    Counters endFrame()
+    {
+        const Counters result = frame;
+        frame = {};
+
+        window.calls += result.calls;
+        window.nanoseconds += result.nanoseconds;
+        window.bytes += result.bytes;
+        if (++frames % ReportInterval == 0)
+        {
+            log::info(
+                "gl calls per frame: {} calls, {} ms cpu, {} bytes uploaded",
+                window.calls / ReportInterval,
+                window.nanoseconds / 1e6 / ReportInterval,
+                window.bytes / ReportInterval);
+            window = {};
+        }
+        return result;
+    }
+
+    void report()
+    {
+        std::size_t order[EntryCount];
+        for (std::size_t entry_n = 0; entry_n < EntryCount; entry_n++)
+        {
+            order[entry_n] = entry_n;
+        }
+        std::sort(std::begin(order), std::end(order), [](std::size_t a, std::size_t b) { return totals[a].nanoseconds > totals[b].nanoseconds; });
+
+        for (std::size_t index : order)
+        {
+            const Counters &counters = totals[index];
+            if (counters.calls == 0)
+            {
+                continue;
+            }
+            log::info(
+                "{}: {} calls, {} ms, {} ns per call, {} bytes",
+                Names[index],
+                counters.calls,
+                counters.nanoseconds / 1e6,
+                counters.nanoseconds / counters.calls,
+                counters.bytes);
+        }
+    }
+}
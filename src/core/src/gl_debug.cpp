@@ -0,0 +1,259 @@
+#include <core/gl_debug.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <core/gl.hpp>
+#include <core/log.hpp>
+
+namespace core::gl::debug
+{
+    namespace
+    {
+        constexpr std::size_t QueueCapacity = 256;
+        constexpr std::size_t MaxMessageLength = 256;
+        constexpr std::uint64_t ReportInterval = 300;
+
+        struct Message
+        {
+            GLuint id;
+            GLenum source;
+            char text[MaxMessageLength];
+        };
+
+        // Bounded multi-producer, single-consumer queue: each slot's sequence
+        // says whether it is free for the producer at that position or
+        // filled for the consumer.
+        class MessageQueue
+        {
+        public:
+            MessageQueue()
+            {
+                for (std::size_t slot_n = 0; slot_n < QueueCapacity; slot_n++)
+                {
+                    slots[slot_n].sequence.store(slot_n, std::memory_order_relaxed);
+                }
+            }
+
+            bool push(GLuint id, GLenum source, std::string_view text)
+            {
+                std::size_t position = tail.load(std::memory_order_relaxed);
+                Slot *slot;
+                for (;;)
+                {
+                    slot = &slots[position % QueueCapacity];
+                    const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                    const std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - position);
+                    if (difference == 0)
+                    {
+                        if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                        {
+                            break;
+                        }
+                    }
+                    else if (difference < 0)
+                    {
+                        dropped.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    else
+                    {
+                        position = tail.load(std::memory_order_relaxed);
+                    }
+                }
+
+                slot->message.id = id;
+                slot->message.source = source;
+                const std::size_t length = std::min(text.size(), MaxMessageLength - 1);
+                std::memcpy(slot->message.text, text.data(), length);
+                slot->message.text[length] = '\0';
+                slot->sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+
+            bool pop(Message &message)
+            {
+                Slot &slot = slots[head % QueueCapacity];
+                if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+                {
+                    return false;
+                }
+                message = slot.message;
+                slot.sequence.store(head + QueueCapacity, std::memory_order_release);
+                head++;
+                return true;
+            }
+
+            std::atomic<std::uint64_t> dropped{0};
+
+        private:
+            struct Slot
+            {
+                std::atomic<std::size_t> sequence;
+                Message message;
+            };
+
+            Slot slots[QueueCapacity];
+            alignas(64) std::atomic<std::size_t> tail{0};
+            alignas(64) std::size_t head = 0;
+        };
+
+        struct Seen
+        {
+            GLuint id;
+            std::uint64_t count;
+            std::string text;
+        };
+
+        MessageQueue queue;
+        std::vector<Seen> seen;
+        std::uint64_t frames = 0;
+        std::uint64_t windowMessages = 0;
+        std::uint64_t reportedDropped = 0;
+
+        const char *sourceName(GLenum source)
+        {
+            switch (source)
+            {
+            case GL_DEBUG_SOURCE_API:
+                return "api";
+            case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
+                return "window system";
+            case GL_DEBUG_SOURCE_SHADER_COMPILER:
+                return "shader compiler";
+            case GL_DEBUG_SOURCE_THIRD_PARTY:
+                return "third party";
+            case GL_DEBUG_SOURCE_APPLICATION:
+                return "application";
+            default:
+                return "other";
+            }
+        }
+
+        const char *typeName(GLenum type)
+        {
+            switch (type)
+            {
+            case GL_DEBUG_TYPE_ERROR:
+                return "error";
+            case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+                return "deprecated";
+            case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+                return "undefined behavior";
+            case GL_DEBUG_TYPE_PORTABILITY:
+                return "portability";
+            case GL_DEBUG_TYPE_PERFORMANCE:
+                return "performance";
+            case GL_DEBUG_TYPE_MARKER:
+                return "marker";
+            default:
+                return "other";
+            }
+        }
+
+        void APIENTRY onMessage(
+            GLenum source,
+            GLenum type,
+            GLuint id,
+            GLenum severity,
+            GLsizei length,
+            const GLchar *message,
+            const void *)
+        {
+            const std::string_view text(message, length >= 0 ? static_cast<std::size_t>(length) : std::strlen(message));
+            if (type == GL_DEBUG_TYPE_PERFORMANCE)
+            {
+                queue.push(id, source, text);
+                return;
+            }
+
+            switch (severity)
+            {
+            case GL_DEBUG_SEVERITY_HIGH:
+                log::error("GL {} {} {}: {}", sourceName(source), typeName(type), id, text);
+                break;
+            case GL_DEBUG_SEVERITY_MEDIUM:
+                log::warning("GL {} {} {}: {}", sourceName(source), typeName(type), id, text);
+                break;
+            case GL_DEBUG_SEVERITY_LOW:
+                log::info("GL {} {} {}: {}", sourceName(source), typeName(type), id, text);
+                break;
+            default:
+                log::debug("GL {} {} {}: {}", sourceName(source), typeName(type), id, text);
+                break;
+            }
+        }
+    }
+
+    bool install()
+    {
+        if (!extensions().debug)
+        {
+            log::warning("GL debug output unavailable: needs GL 4.3 or KHR_debug");
+            return false;
+        }
+
+        GLint flags = 0;
+        glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+        glEnable(GL_DEBUG_OUTPUT);
+        debugMessageCallback(onMessage, nullptr);
+        filter(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, true);
+        filter(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, false);
+        log::info("GL debug output installed ({}debug context)", flags & GL_CONTEXT_FLAG_DEBUG_BIT ? "" : "not a ");
+        return true;
+    }
+
+    void filter(GLenum source, GLenum type, GLenum severity, bool enabled)
+    {
+        if (debugMessageControl)
+        {
+            debugMessageControl(source, type, severity, 0, nullptr, enabled ? GL_TRUE : GL_FALSE);
+        }
+    }
+
+    std::size_t endFrame()
+    {
+        std::size_t count = 0;
+        Message message;
+        while (queue.pop(message))
+        {
+            count++;
+            auto entry = std::find_if(seen.begin(), seen.end(), [&message](const Seen &entry) { return entry.id == message.id; });
+            if (entry == seen.end())
+            {
+                log::warning("GL performance {} {}: {}", sourceName(message.source), message.id, message.text);
+                seen.push_back({message.id, 0, message.text});
+                entry = seen.end() - 1;
+            }
+            entry->count++;
+        }
+
+        windowMessages += count;
+        if (++frames % ReportInterval == 0 && windowMessages > 0)
+        {
+            log::warning("{} GL performance messages in the last {} frames", windowMessages, ReportInterval);
+            windowMessages = 0;
+        }
+
+        const std::uint64_t dropped = queue.dropped.load(std::memory_order_relaxed);
+        if (dropped != reportedDropped)
+        {
+            log::warning("GL debug queue full, dropped {} performance messages", dropped - reportedDropped);
+            reportedDropped = dropped;
+        }
+        return count;
+    }
+
+    void report()
+    {
+        for (const Seen &entry : seen)
+        {
+            log::info("GL performance {}: {} times: {}", entry.id, entry.count, entry.text);
+        }
+    }
+}
@@ -0,0 +1,161 @@
+#include <core/gpu_profiler.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include <core/log.hpp>
+
+namespace core
+{
+    GpuProfiler::Zone::Zone(GpuProfiler *profiler, const char *name) : profiler(profiler)
+    {
+        if (profiler)
+        {
+            index = profiler->begin(name);
+        }
+    }
+
+    GpuProfiler::Zone::~Zone()
+    {
+        if (profiler)
+        {
+            profiler->end(index);
+        }
+    }
+
+    GpuProfiler::GpuProfiler(std::size_t window) : window(window)
+    {
+    }
+
+    GpuProfiler::~GpuProfiler()
+    {
+        if (!queries.empty())
+        {
+            glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+        }
+    }
+
+    void GpuProfiler::beginFrame()
+    {
+        collect();
+        recording = {};
+    }
+
+    void GpuProfiler::endFrame()
+    {
+        if (!recording.timings.empty())
+        {
+            pending.push_back(std::move(recording));
+            recording = {};
+        }
+
+        if (++frames % ReportInterval == 0)
+        {
+            report();
+        }
+    }
+
+    std::size_t GpuProfiler::begin(const char *name)
+    {
+        const GLuint query = acquire();
+        glQueryCounter(query, GL_TIMESTAMP);
+        recording.timings.push_back({name, query, 0});
+        recording.last = query;
+        return recording.timings.size() - 1;
+    }
+
+    void GpuProfiler::end(std::size_t index)
+    {
+        const GLuint query = acquire();
+        glQueryCounter(query, GL_TIMESTAMP);
+        recording.timings[index].end = query;
+        recording.last = query;
+    }
+
+    GLuint GpuProfiler::acquire()
+    {
+        if (pool.empty())
+        {
+            GLuint query;
+            glGenQueries(1, &query);
+            queries.push_back(query);
+            return query;
+        }
+        const GLuint query = pool.back();
+        pool.pop_back();
+        return query;
+    }
+
+    void GpuProfiler::collect()
+    {
+        while (!pending.empty())
+        {
+            const Frame &frame = pending.front();
+
+            // Queries complete in order, so the frame's last one decides.
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(frame.last, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+            {
+                return;
+            }
+
+            // Zones sharing a name within a frame add up to one sample.
+            std::vector<std::pair<const char *, double>> totals;
+            for (const Timing &timing : frame.timings)
+            {
+                GLuint64 begin = 0;
+                GLuint64 end = 0;
+                glGetQueryObjectui64v(timing.begin, GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(timing.end, GL_QUERY_RESULT, &end);
+                pool.push_back(timing.begin);
+                pool.push_back(timing.end);
+
+                auto total = std::find_if(totals.begin(), totals.end(), [&timing](const auto &total) { return std::strcmp(total.first, timing.name) == 0; });
+                if (total == totals.end())
+                {
+                    totals.emplace_back(timing.name, .0);
+                    total = totals.end() - 1;
+                }
+                total->second += (end - begin) / 1e6;
+            }
+            for (const auto &[name, milliseconds] : totals)
+            {
+                record(name, milliseconds);
+            }
+            pending.pop_front();
+        }
+    }
+
+    void GpuProfiler::record(const char *name, double milliseconds)
+    {
+        auto pass = std::find_if(passes.begin(), passes.end(), [name](const Pass &pass) { return std::strcmp(pass.name, name) == 0; });
+        if (pass == passes.end())
+        {
+            passes.push_back({name, {}, 0});
+            pass = passes.end() - 1;
+        }
+
+        if (pass->samples.size() < window)
+        {
+            pass->samples.push_back(milliseconds);
+        }
+        else
+        {
+            pass->samples[pass->next] = milliseconds;
+        }
+        pass->next = (pass->next + 1) % window;
+    }
+
+    void GpuProfiler::report() const
+    {
+        for (const Pass &pass : passes)
+        {
+            std::vector<double> sorted = pass.samples;
+            std::sort(sorted.begin(), sorted.end());
+            auto at = [&sorted](double point) { return sorted[static_cast<std::size_t>(point * (sorted.size() - 1))]; };
+            log::info("gpu {}: p50 {} ms, p95 {} ms, p99 {} ms over {} frames", pass.name, at(.50), at(.95), at(.99), sorted.size());
+        }
+    }
+}
@@ -0,0 +1,153 @@
+#include <core/headless.hpp>
+
+#ifdef CORE_HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#include <core/gl.hpp>
+#include <core/log.hpp>
+
+namespace core
+{
+    namespace
+    {
+#ifdef CORE_HAVE_EGL
+        void *eglLoader(const char *name)
+        {
+            return reinterpret_cast<void *>(eglGetProcAddress(name));
+        }
+#else
+        void *glfwLoader(const char *name)
+        {
+            return reinterpret_cast<void *>(glfwGetProcAddress(name));
+        }
+#endif
+    }
+
+#ifdef CORE_HAVE_EGL
+    HeadlessContext::HeadlessContext(bool debug)
+    {
+        EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+        const char *clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay && gl::hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless"))
+        {
+            eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+        if (eglDisplay == EGL_NO_DISPLAY)
+        {
+            eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        EGLint major = 0;
+        EGLint minor = 0;
+        if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor) || !eglBindAPI(EGL_OPENGL_API))
+        {
+            log::error("Failed to initialize EGL");
+            return;
+        }
+        display = eglDisplay;
+
+        const EGLint configAttributes[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_NONE};
+        EGLConfig config = nullptr;
+        EGLint configCount = 0;
+        if (!eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount) || configCount == 0)
+        {
+            // Surfaceless displays may offer no configs at all.
+            config = nullptr;
+        }
+
+        const EGLint contextAttributes[] = {
+            EGL_CONTEXT_MAJOR_VERSION, 3,
+            EGL_CONTEXT_MINOR_VERSION, 3,
+            EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+            EGL_CONTEXT_OPENGL_DEBUG, debug ? EGL_TRUE : EGL_FALSE,
+            EGL_NONE};
+        EGLContext eglContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, contextAttributes);
+        if (eglContext == EGL_NO_CONTEXT)
+        {
+            log::error("Failed to create EGL context (error {})", eglGetError());
+            return;
+        }
+        context = eglContext;
+
+        EGLSurface eglSurface = EGL_NO_SURFACE;
+        if (config && !gl::hasExtension(eglQueryString(eglDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+        {
+            const EGLint surfaceAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+            eglSurface = eglCreatePbufferSurface(eglDisplay, config, surfaceAttributes);
+            surface = eglSurface;
+        }
+
+        if (!eglMakeCurrent(eglDisplay, eglSurface, eglSurface, eglContext))
+        {
+            log::error("Failed to make the EGL context current");
+            return;
+        }
+        created = true;
+        log::debug("headless context on EGL {}.{}", major, minor);
+    }
+
+    HeadlessContext::~HeadlessContext()
+    {
+        if (display)
+        {
+            eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (surface)
+            {
+                eglDestroySurface(display, surface);
+            }
+            if (context)
+            {
+                eglDestroyContext(display, context);
+            }
+            eglTerminate(display);
+        }
+    }
+
+    GLADloadproc HeadlessContext::loader() const
+    {
+        return eglLoader;
+    }
+#else
+    HeadlessContext::HeadlessContext(bool debug)
+    {
+        glfwInit();
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, debug ? GLFW_TRUE : GLFW_FALSE);
+
+        window = glfwCreateWindow(1, 1, "headless", nullptr, nullptr);
+        if (!window)
+        {
+            log::error("Failed to create hidden GLFW window");
+            return;
+        }
+        glfwMakeContextCurrent(window);
+        created = true;
+    }
+
+    HeadlessContext::~HeadlessContext()
+    {
+        if (window)
+        {
+            glfwDestroyWindow(window);
+        }
+        glfwTerminate();
+    }
+
+    GLADloadproc HeadlessContext::loader() const
+    {
+        return glfwLoader;
+    }
+#endif
+}
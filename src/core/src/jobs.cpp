@@ -0,0 +1,273 @@
+#include <core/jobs.hpp>
+
+#include <algorithm>
+
+namespace core
+{
+    namespace
+    {
+        thread_local const JobSystem *currentSystem = nullptr;
+        thread_local std::size_t currentWorker = 0;
+
+        // Rounds without work a waiting thread yields through before it
+        // sleeps; short waits then cost no wake-up.
+        constexpr int SpinLimit = 64;
+    }
+
+    JobSystem::JobSystem(std::size_t workerCount)
+    {
+        // One deque per worker plus the injection queue for outside threads.
+        for (std::size_t queue_n = 0; queue_n <= workerCount; queue_n++)
+        {
+            queues.push_back(std::make_unique<WorkQueue>());
+        }
+        for (std::size_t worker_n = 0; worker_n < workerCount; worker_n++)
+        {
+            workers.emplace_back([this, worker_n] { workerLoop(worker_n); });
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        stopping.store(true, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        sleep.notify_all();
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    TaskHandle JobSystem::createTask(std::function<void()> work)
+    {
+        return std::make_shared<Task>(std::move(work));
+    }
+
+    void JobSystem::addDependency(const TaskHandle &task, const TaskHandle &prerequisite)
+    {
+        std::lock_guard<std::mutex> lock(prerequisite->mutex);
+        if (!prerequisite->done.load(std::memory_order_relaxed))
+        {
+            task->pending.fetch_add(1, std::memory_order_relaxed);
+            prerequisite->successors.push_back(task);
+        }
+    }
+
+    void JobSystem::submit(const TaskHandle &task)
+    {
+        if (task->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            enqueue(task);
+        }
+    }
+
+    TaskHandle JobSystem::run(std::function<void()> work)
+    {
+        TaskHandle task = createTask(std::move(work));
+        submit(task);
+        return task;
+    }
+
+    void JobSystem::wait(const TaskHandle &task)
+    {
+        if (task->finished())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(task->mutex);
+            task->awaited = true;
+        }
+        helpUntil([&task] { return task->finished(); });
+    }
+
+    void JobSystem::parallelForChunks(
+        std::size_t begin,
+        std::size_t end,
+        std::size_t grain,
+        std::function<void(std::size_t, std::size_t)> function)
+    {
+        grain = std::max<std::size_t>(grain, 1);
+        const std::size_t chunkCount = (end - begin + grain - 1) / grain;
+        std::atomic<std::size_t> remaining{chunkCount - 1};
+
+        for (std::size_t chunk_n = 1; chunk_n < chunkCount; chunk_n++)
+        {
+            const std::size_t chunkBegin = begin + chunk_n * grain;
+            const std::size_t chunkEnd = std::min(chunkBegin + grain, end);
+            submit(createTask(
+                [this, &function, &remaining, chunkBegin, chunkEnd]
+                {
+                    function(chunkBegin, chunkEnd);
+                    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        wakeSleepers();
+                    }
+                }));
+        }
+
+        function(begin, std::min(begin + grain, end));
+
+        helpUntil([&remaining] { return remaining.load(std::memory_order_acquire) == 0; });
+    }
+
+    void JobSystem::helpUntil(const std::function<bool()> &ready)
+    {
+        int idle = 0;
+        while (!ready())
+        {
+            if (runOne())
+            {
+                idle = 0;
+            }
+            else if (idle++ < SpinLimit)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                // Sleeps with the workers: enqueue() wakes it for new work and
+                // wakeSleepers() once `ready` may have turned true.
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleep.wait(lock, [&] { return ready() || queued.load(std::memory_order_acquire) > 0; });
+                idle = 0;
+            }
+        }
+    }
+
+    void JobSystem::wakeSleepers()
+    {
+        // Taking the lock orders this wake-up after a sleeper's predicate check.
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        sleep.notify_all();
+    }
+
+    void JobSystem::enqueue(TaskHandle task)
+    {
+        const std::size_t target = currentSystem == this ? currentWorker : workers.size();
+        queued.fetch_add(1, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(queues[target]->mutex);
+            queues[target]->tasks.push_back(std::move(task));
+        }
+
+        // Taking the lock orders this wake-up after a sleeper's predicate check.
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        sleep.notify_one();
+    }
+
+    TaskHandle JobSystem::dequeue(std::size_t self)
+    {
+        TaskHandle task;
+        const std::size_t queueCount = queues.size();
+
+        if (self < workers.size())
+        {
+            WorkQueue &own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+            }
+        }
+
+        // Steal the oldest work, starting with the injection queue.
+        for (std::size_t offset = 0; !task && offset < queueCount; offset++)
+        {
+            const std::size_t victim = (workers.size() + offset) % queueCount;
+            if (victim == self && self < workers.size())
+            {
+                continue;
+            }
+            WorkQueue &queue = *queues[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+        }
+
+        if (task)
+        {
+            queued.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    bool JobSystem::runOne()
+    {
+        if (queued.load(std::memory_order_acquire) == 0)
+        {
+            return false;
+        }
+        const std::size_t self = currentSystem == this ? currentWorker : workers.size();
+        TaskHandle task = dequeue(self);
+        if (!task)
+        {
+            return false;
+        }
+        execute(task);
+        return true;
+    }
+
+    void JobSystem::execute(const TaskHandle &task)
+    {
+        task->work();
+        task->work = nullptr;
+
+        std::vector<TaskHandle> successors;
+        bool awaited;
+        {
+            std::lock_guard<std::mutex> lock(task->mutex);
+            task->done.store(true, std::memory_order_release);
+            successors.swap(task->successors);
+            awaited = task->awaited;
+        }
+        if (awaited)
+        {
+            wakeSleepers();
+        }
+        for (const TaskHandle &successor : successors)
+        {
+            if (successor->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                enqueue(successor);
+            }
+        }
+    }
+
+    void JobSystem::workerLoop(std::size_t index)
+    {
+        currentSystem = this;
+        currentWorker = index;
+
+        while (!stopping.load(std::memory_order_acquire))
+        {
+            if (runOne())
+            {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            sleep.wait(
+                lock,
+                [this]
+                {
+                    return stopping.load(std::memory_order_acquire) || queued.load(std::memory_order_acquire) > 0;
+                });
+        }
+    }
+
+    JobSystem &jobs()
+    {
+        static JobSystem instance(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+        return instance;
+    }
+}
@@ -0,0 +1,520 @@
+#include <core/log.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <core/clock.hpp>
+
+namespace core::log
+{
+    namespace
+    {
+        constexpr std::size_t BufferCapacity = 64 * 1024;
+        constexpr std::size_t MaxStringLength = 4 * 1024;
+        // A thread buffer filling past this wakes the writer right away
+        // rather than at the end of the batch interval.
+        constexpr std::size_t FillThreshold = BufferCapacity / 2;
+        // How long the writer lets a batch collect after its first record.
+        constexpr auto WriteInterval = std::chrono::milliseconds(2);
+
+        struct RecordHeader
+        {
+            const char *format;
+            std::int64_t timestamp;
+            std::uint32_t size;
+            Level level;
+            std::uint8_t argumentCount;
+        };
+
+        // Single producer (the owning thread), single consumer (the writer).
+        class ThreadBuffer
+        {
+        public:
+            explicit ThreadBuffer(std::uint32_t index) : index(index)
+            {
+            }
+
+            // `filling` is set when the record takes the buffer past
+            // FillThreshold (as far as this thread last saw the tail).
+            bool push(const RecordHeader &header, const Argument *arguments, bool &filling)
+            {
+                const std::uint64_t head = this->head.load(std::memory_order_relaxed);
+                if (BufferCapacity - (head - cachedTail) < header.size)
+                {
+                    cachedTail = tail.load(std::memory_order_acquire);
+                    if (BufferCapacity - (head - cachedTail) < header.size)
+                    {
+                        dropped.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                }
+
+                std::uint64_t offset = head;
+                put(offset, &header, sizeof(header));
+                for (std::uint8_t argument_n = 0; argument_n < header.argumentCount; argument_n++)
+                {
+                    const Argument &argument = arguments[argument_n];
+                    put(offset, &argument.type, sizeof(argument.type));
+                    if (argument.type == ArgumentType::String)
+                    {
+                        const std::uint32_t length = std::min(argument.text.size(), MaxStringLength);
+                        put(offset, &length, sizeof(length));
+                        put(offset, argument.text.data(), length);
+                    }
+                    else
+                    {
+                        put(offset, &argument.u, sizeof(argument.u));
+                    }
+                }
+
+                this->head.store(head + header.size, std::memory_order_release);
+                filling = head - cachedTail < FillThreshold && head + header.size - cachedTail >= FillThreshold;
+                return true;
+            }
+
+            // Formats every pending record; called from the writer thread only.
+            template <typename Sink>
+            void drain(Sink &&sink)
+            {
+                const std::uint64_t head = this->head.load(std::memory_order_acquire);
+                std::uint64_t offset = tail.load(std::memory_order_relaxed);
+                Argument arguments[UINT8_MAX];
+                std::string strings[UINT8_MAX];
+
+                while (offset < head)
+                {
+                    const std::uint64_t start = offset;
+                    RecordHeader header;
+                    get(offset, &header, sizeof(header));
+                    for (std::uint8_t argument_n = 0; argument_n < header.argumentCount; argument_n++)
+                    {
+                        Argument &argument = arguments[argument_n];
+                        get(offset, &argument.type, sizeof(argument.type));
+                        if (argument.type == ArgumentType::String)
+                        {
+                            std::uint32_t length;
+                            get(offset, &length, sizeof(length));
+                            strings[argument_n].resize(length);
+                            get(offset, strings[argument_n].data(), length);
+                            argument.text = strings[argument_n];
+                        }
+                        else
+                        {
+                            get(offset, &argument.u, sizeof(argument.u));
+                        }
+                    }
+                    sink(index, header, arguments);
+                    offset = start + header.size;
+                }
+
+                tail.store(offset, std::memory_order_release);
+            }
+
+            bool empty() const
+            {
+                return head.load(std::memory_order_acquire) == tail.load(std::memory_order_relaxed);
+            }
+
+            const std::uint32_t index;
+            std::atomic<std::uint64_t> dropped{0};
+            std::uint64_t reportedDropped = 0;
+            std::atomic<bool> orphaned{false};
+
+        private:
+            void put(std::uint64_t &offset, const void *source, std::size_t size)
+            {
+                const std::size_t position = offset % BufferCapacity;
+                const std::size_t first = std::min(size, BufferCapacity - position);
+                std::memcpy(storage + position, source, first);
+                std::memcpy(storage, static_cast<const char *>(source) + first, size - first);
+                offset += size;
+            }
+
+            void get(std::uint64_t &offset, void *destination, std::size_t size) const
+            {
+                const std::size_t position = offset % BufferCapacity;
+                const std::size_t first = std::min(size, BufferCapacity - position);
+                std::memcpy(destination, storage + position, first);
+                std::memcpy(static_cast<char *>(destination) + first, storage, size - first);
+                offset += size;
+            }
+
+            alignas(64) std::atomic<std::uint64_t> head{0};
+            std::uint64_t cachedTail = 0;
+            alignas(64) std::atomic<std::uint64_t> tail{0};
+            char storage[BufferCapacity];
+        };
+
+        void appendArgument(std::string &out, const Argument &argument)
+        {
+            char scratch[32];
+            int length = 0;
+            switch (argument.type)
+            {
+            case ArgumentType::Signed:
+                length = std::snprintf(scratch, sizeof(scratch), "%lld", static_cast<long long>(argument.i));
+                break;
+            case ArgumentType::Unsigned:
+                length = std::snprintf(scratch, sizeof(scratch), "%llu", static_cast<unsigned long long>(argument.u));
+                break;
+            case ArgumentType::Floating:
+                length = std::snprintf(scratch, sizeof(scratch), "%g", argument.f);
+                break;
+            case ArgumentType::Boolean:
+                out += argument.u ? "true" : "false";
+                return;
+            case ArgumentType::Character:
+                out += static_cast<char>(argument.u);
+                return;
+            case ArgumentType::Pointer:
+                length = std::snprintf(scratch, sizeof(scratch), "%p", argument.p);
+                break;
+            case ArgumentType::String:
+                out += argument.text;
+                return;
+            }
+            out.append(scratch, std::max(length, 0));
+        }
+
+        void format(std::string &out, const char *format, const Argument *arguments, std::size_t count)
+        {
+            std::size_t argument_n = 0;
+            for (const char *cursor = format; *cursor; cursor++)
+            {
+                if (cursor[0] == '{' && cursor[1] == '}')
+                {
+                    if (argument_n < count)
+                    {
+                        appendArgument(out, arguments[argument_n++]);
+                    }
+                    cursor++;
+                }
+                else
+                {
+                    out += *cursor;
+                }
+            }
+        }
+
+        const char *levelName(Level level)
+        {
+            switch (level)
+            {
+            case Level::Debug:
+                return "DEBUG";
+            case Level::Info:
+                return "INFO ";
+            case Level::Warning:
+                return "WARN ";
+            case Level::Error:
+                return "ERROR";
+            }
+            return "?????";
+        }
+
+        class Logger
+        {
+        public:
+            Logger() : start(startupTime()), writer([this] { run(); })
+            {
+            }
+
+            ~Logger()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+                wake.notify_one();
+                writer.join();
+            }
+
+            std::shared_ptr<ThreadBuffer> registerThread()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                buffers.push_back(std::make_shared<ThreadBuffer>(nextThreadIndex++));
+                return buffers.back();
+            }
+
+            std::int64_t now() const
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+            }
+
+            void flush()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                const std::uint64_t target = ++requestedGeneration;
+                wake.notify_one();
+                flushed.wait(lock, [&] { return writtenGeneration >= target || stopping; });
+            }
+
+            // Called after every record. Only takes the lock for the first
+            // record the sleeping writer has not seen, or when `filling`.
+            // The fence pairs with the one in run(): either the writer sees
+            // this record or this sees `sleeping`. Loading before the
+            // exchange keeps the flag's cache line shared while the writer
+            // is awake.
+            void recorded(bool filling)
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!filling && !(sleeping.load(std::memory_order_relaxed) && sleeping.exchange(false)))
+                {
+                    return;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    arrived = true;
+                    urgent = urgent || filling;
+                }
+                wake.notify_one();
+            }
+
+            std::uint64_t droppedCount()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                std::uint64_t total = orphanedDropped;
+                for (const std::shared_ptr<ThreadBuffer> &buffer : buffers)
+                {
+                    total += buffer->dropped.load(std::memory_order_relaxed);
+                }
+                return total;
+            }
+
+        private:
+            struct Line
+            {
+                std::int64_t timestamp;
+                std::size_t begin;
+                std::size_t end;
+            };
+
+            void run()
+            {
+                std::vector<std::shared_ptr<ThreadBuffer>> snapshot;
+                bool done = false;
+                while (!done)
+                {
+                    std::uint64_t generation;
+                    {
+                        // Sleeps without a timeout while every buffer is
+                        // empty; the first record after that wakes it (see
+                        // recorded()), and the batch then gets WriteInterval
+                        // to collect unless a flush, shutdown or filling
+                        // buffer needs it written now.
+                        std::unique_lock<std::mutex> lock(mutex);
+                        sleeping.store(true);
+                        std::atomic_thread_fence(std::memory_order_seq_cst);
+                        if (!pending())
+                        {
+                            wake.wait(lock, [&] { return stopping || requestedGeneration > writtenGeneration || arrived; });
+                        }
+                        sleeping.store(false);
+                        wake.wait_for(lock, WriteInterval, [&] { return stopping || requestedGeneration > writtenGeneration || urgent; });
+                        arrived = false;
+                        urgent = false;
+                        done = stopping;
+                        generation = requestedGeneration;
+                        snapshot = buffers;
+                    }
+
+                    writeBatch(snapshot);
+
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        writtenGeneration = generation;
+                        buffers.erase(
+                            std::remove_if(
+                                buffers.begin(),
+                                buffers.end(),
+                                [&](const std::shared_ptr<ThreadBuffer> &buffer)
+                                {
+                                    const bool retire = buffer->orphaned.load(std::memory_order_acquire) && buffer->empty();
+                                    if (retire)
+                                    {
+                                        orphanedDropped += buffer->dropped.load(std::memory_order_relaxed);
+                                    }
+                                    return retire;
+                                }),
+                            buffers.end());
+                    }
+                    flushed.notify_all();
+                }
+
+                const std::uint64_t dropped = droppedCount();
+                if (dropped > 0)
+                {
+                    std::fprintf(stdout, "[%12.6f] WARN  log dropped %llu records in total\n", now() / 1e9, static_cast<unsigned long long>(dropped));
+                    std::fflush(stdout);
+                }
+            }
+
+            // Under `mutex`.
+            bool pending() const
+            {
+                for (const std::shared_ptr<ThreadBuffer> &buffer : buffers)
+                {
+                    if (!buffer->empty())
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void writeBatch(const std::vector<std::shared_ptr<ThreadBuffer>> &snapshot)
+            {
+                batch.clear();
+                lines.clear();
+
+                for (const std::shared_ptr<ThreadBuffer> &buffer : snapshot)
+                {
+                    buffer->drain(
+                        [&](std::uint32_t thread, const RecordHeader &header, const Argument *arguments)
+                        {
+                            const std::size_t begin = batch.size();
+                            char prefix[64];
+                            const int length = std::snprintf(
+                                prefix,
+                                sizeof(prefix),
+                                "[%12.6f] [T%u] %s ",
+                                header.timestamp / 1e9,
+                                thread,
+                                levelName(header.level));
+                            batch.append(prefix, std::max(length, 0));
+                            format(batch, header.format, arguments, header.argumentCount);
+                            batch += '\n';
+                            lines.push_back({header.timestamp, begin, batch.size()});
+                        });
+
+                    const std::uint64_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+                    if (dropped != buffer->reportedDropped)
+                    {
+                        char notice[96];
+                        const int length = std::snprintf(
+                            notice,
+                            sizeof(notice),
+                            "[%12.6f] [T%u] WARN  log buffer full, dropped %llu records\n",
+                            now() / 1e9,
+                            buffer->index,
+                            static_cast<unsigned long long>(dropped - buffer->reportedDropped));
+                        const std::size_t begin = batch.size();
+                        batch.append(notice, std::max(length, 0));
+                        lines.push_back({now(), begin, batch.size()});
+                        buffer->reportedDropped = dropped;
+                    }
+                }
+
+                if (lines.empty())
+                {
+                    return;
+                }
+
+                // Keep the output chronological across threads.
+                std::stable_sort(
+                    lines.begin(),
+                    lines.end(),
+                    [](const Line &a, const Line &b) { return a.timestamp < b.timestamp; });
+                ordered.clear();
+                for (const Line &line : lines)
+                {
+                    ordered.append(batch, line.begin, line.end - line.begin);
+                }
+
+                std::fwrite(ordered.data(), 1, ordered.size(), stdout);
+                std::fflush(stdout);
+            }
+
+            const Clock::time_point start;
+
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable flushed;
+            std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+            std::uint32_t nextThreadIndex = 0;
+            std::uint64_t orphanedDropped = 0;
+            std::uint64_t requestedGeneration = 0;
+            std::uint64_t writtenGeneration = 0;
+            bool stopping = false;
+            // Set by recorded() for the writer.
+            bool arrived = false;
+            bool urgent = false;
+            // While true, the next record has to wake the writer.
+            std::atomic<bool> sleeping{false};
+
+            std::string batch;
+            std::string ordered;
+            std::vector<Line> lines;
+
+            std::thread writer;
+        };
+
+        Logger &logger()
+        {
+            static Logger instance;
+            return instance;
+        }
+
+        struct ThreadRegistration
+        {
+            ThreadRegistration() : buffer(logger().registerThread())
+            {
+            }
+
+            ~ThreadRegistration()
+            {
+                buffer->orphaned.store(true, std::memory_order_release);
+            }
+
+            std::shared_ptr<ThreadBuffer> buffer;
+        };
+    }
+
+    namespace detail
+    {
+        void write(Level level, const char *format, const Argument *arguments, std::size_t count)
+        {
+            thread_local ThreadRegistration registration;
+
+            RecordHeader header;
+            header.format = format;
+            header.timestamp = logger().now();
+            header.level = level;
+            header.argumentCount = static_cast<std::uint8_t>(std::min<std::size_t>(count, UINT8_MAX));
+
+            std::size_t size = sizeof(header);
+            for (std::uint8_t argument_n = 0; argument_n < header.argumentCount; argument_n++)
+            {
+                size += sizeof(ArgumentType);
+                size += arguments[argument_n].type == ArgumentType::String
+                            ? sizeof(std::uint32_t) + std::min(arguments[argument_n].text.size(), MaxStringLength)
+                            : sizeof(std::uint64_t);
+            }
+            header.size = static_cast<std::uint32_t>(size);
+
+            bool filling = false;
+            if (registration.buffer->push(header, arguments, filling))
+            {
+                logger().recorded(filling);
+            }
+        }
+    }
+
+    void flush()
+    {
+        logger().flush();
+    }
+
+    std::uint64_t droppedCount()
+    {
+        return logger().droppedCount();
+    }
+}
@@ -0,0 +1,195 @@
+#include <core/mesh.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
+#include <core/profile.hpp>
+
+namespace core::mesh
+{
+    namespace
+    {
+        constexpr double Circle = 2 * M_PI;
+
+        // Below this many items per chunk the scheduling cost outweighs the work.
+        constexpr std::size_t Grain = 4096;
+
+        struct Key
+        {
+            std::int64_t x;
+            std::int64_t y;
+            std::int64_t z;
+
+            bool operator==(const Key &other) const
+            {
+                return x == other.x && y == other.y && z == other.z;
+            }
+        };
+
+        struct KeyHash
+        {
+            std::size_t operator()(const Key &key) const
+            {
+                std::uint64_t hash = 1469598103934665603ull;
+                for (std::int64_t component : {key.x, key.y, key.z})
+                {
+                    hash = (hash ^ static_cast<std::uint64_t>(component)) * 1099511628211ull;
+                }
+                return hash;
+            }
+        };
+    }
+
+    Mesh circleFan(std::size_t divisions, JobSystem &jobs)
+    {
+        CORE_PROFILE_ZONE("mesh generation");
+        const double angle = Circle / divisions;
+        Mesh mesh;
+        mesh.vertices.resize(divisions * 9);
+
+        jobs.parallelFor(
+            0,
+            divisions,
+            Grain,
+            [&](std::size_t begin, std::size_t end)
+            {
+                for (std::size_t division_n = begin; division_n < end; division_n++)
+                {
+                    float start = division_n * angle;
+                    float stop = (division_n + 1) * angle;
+                    float *vertex = &mesh.vertices[division_n * 9];
+
+                    vertex[0] = .0f;                // center
+                    vertex[1] = .0f;
+                    vertex[2] = .0f;
+                    vertex[3] = std::cos(start);    // start
+                    vertex[4] = std::sin(start);
+                    vertex[5] = .0f;
+                    vertex[6] = std::cos(stop);     // end
+                    vertex[7] = std::sin(stop);
+                    vertex[8] = .0f;
+                }
+            });
+
+        return mesh;
+    }
+
+    Mesh circleIndexed(std::size_t divisions, JobSystem &jobs)
+    {
+        CORE_PROFILE_ZONE("mesh generation");
+        const double angle = Circle / divisions;
+        Mesh mesh;
+        mesh.vertices.resize((divisions + 1) * 3);
+        mesh.indices.resize(divisions * 3);
+
+        jobs.parallelFor(
+            0,
+            divisions,
+            Grain,
+            [&](std::size_t begin, std::size_t end)
+            {
+                for (std::size_t division_n = begin; division_n < end; division_n++)
+                {
+                    float angle_n = division_n * angle;
+                    float *vertex = &mesh.vertices[(division_n + 1) * 3];
+                    unsigned int *index = &mesh.indices[division_n * 3];
+
+                    vertex[0] = std::cos(angle_n);  // x
+                    vertex[1] = std::sin(angle_n);  // y
+                    vertex[2] = .0f;                // z
+
+                    index[0] = 0;                                   // center
+                    index[1] = division_n + 1;                      // current xyz
+                    index[2] = ((division_n + 1) % divisions) + 1;  // next (expected) xyz
+                }
+            });
+
+        return mesh;
+    }
+
+    Bounds bounds(const Mesh &mesh)
+    {
+        if (mesh.vertices.empty())
+        {
+            return {};
+        }
+        Bounds extent = {mesh.vertices[0], mesh.vertices[1], mesh.vertices[0], mesh.vertices[1]};
+        for (std::size_t vertex_n = 3; vertex_n + 1 < mesh.vertices.size(); vertex_n += 3)
+        {
+            extent.left = std::min(extent.left, mesh.vertices[vertex_n]);
+            extent.right = std::max(extent.right, mesh.vertices[vertex_n]);
+            extent.bottom = std::min(extent.bottom, mesh.vertices[vertex_n + 1]);
+            extent.top = std::max(extent.top, mesh.vertices[vertex_n + 1]);
+        }
+        return extent;
+    }
+
+    Mesh weld(const std::vector<float> &vertices, float tolerance, JobSystem &jobs)
+    {
+        CORE_PROFILE_ZONE("mesh weld");
+        const std::size_t vertexCount = vertices.size() / 3;
+        const double scale = 1.0 / tolerance;
+        std::vector<Key> keys(vertexCount);
+
+        jobs.parallelFor(
+            0,
+            vertexCount,
+            Grain,
+            [&](std::size_t begin, std::size_t end)
+            {
+                for (std::size_t vertex_n = begin; vertex_n < end; vertex_n++)
+                {
+                    const float *vertex = &vertices[vertex_n * 3];
+                    keys[vertex_n] = {
+                        std::llround(vertex[0] * scale),
+                        std::llround(vertex[1] * scale),
+                        std::llround(vertex[2] * scale)};
+                }
+            });
+
+        // Index assignment is order dependent, so it stays on one thread.
+        Mesh mesh;
+        mesh.indices.resize(vertexCount);
+        std::unordered_map<Key, unsigned int, KeyHash> unique;
+        unique.reserve(vertexCount);
+        for (std::size_t vertex_n = 0; vertex_n < vertexCount; vertex_n++)
+        {
+            auto [found, inserted] = unique.try_emplace(keys[vertex_n], static_cast<unsigned int>(unique.size()));
+            if (inserted)
+            {
+                mesh.vertices.insert(mesh.vertices.end(), &vertices[vertex_n * 3], &vertices[vertex_n * 3] + 3);
+            }
+            mesh.indices[vertex_n] = found->second;
+        }
+
+        return mesh;
+    }
+
+    double acmr(const Mesh &mesh, std::size_t cacheSize)
+    {
+        if (mesh.indices.empty())
+        {
+            return 3.0;
+        }
+
+        std::deque<unsigned int> cache;
+        std::size_t misses = 0;
+        for (unsigned int index : mesh.indices)
+        {
+            if (std::find(cache.begin(), cache.end(), index) != cache.end())
+            {
+                continue;
+            }
+            misses++;
+            cache.push_back(index);
+            if (cache.size() > cacheSize)
+            {
+                cache.pop_front();
+            }
+        }
+        return static_cast<double>(misses) / (mesh.indices.size() / 3);
+    }
+}
@@ -0,0 +1,87 @@
+#include <core/mesh_buffers.hpp>
+
+#include <utility>
+
+#include <core/profile.hpp>
+
+namespace core
+{
+    MeshBuffers::MeshBuffers(const mesh::Mesh &mesh)
+        : vertices(static_cast<GLsizei>(mesh.vertices.size() / 3)), indices(static_cast<GLsizei>(mesh.indices.size()))
+    {
+        CORE_PROFILE_ZONE("buffer upload");
+        glGenVertexArrays(1, &vertexArrayId);
+        glBindVertexArray(vertexArrayId);
+
+        glGenBuffers(1, &vertexBufferId);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBufferId);
+        glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(float), mesh.vertices.data(), GL_STATIC_DRAW);
+
+        if (!mesh.indices.empty())
+        {
+            glGenBuffers(1, &indexBufferId);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferId);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(unsigned int), mesh.indices.data(), GL_STATIC_DRAW);
+        }
+
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+        glEnableVertexAttribArray(0);
+    }
+
+    MeshBuffers::~MeshBuffers()
+    {
+        release();
+    }
+
+    MeshBuffers::MeshBuffers(MeshBuffers &&other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MeshBuffers &MeshBuffers::operator=(MeshBuffers &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            vertexArrayId = std::exchange(other.vertexArrayId, 0);
+            vertexBufferId = std::exchange(other.vertexBufferId, 0);
+            indexBufferId = std::exchange(other.indexBufferId, 0);
+            vertices = std::exchange(other.vertices, 0);
+            indices = std::exchange(other.indices, 0);
+        }
+        return *this;
+    }
+
+    void MeshBuffers::bind() const
+    {
+        glBindVertexArray(vertexArrayId);
+    }
+
+    DrawCommand MeshBuffers::draw(GLenum mode) const
+    {
+        DrawCommand command = {mode, vertices};
+        if (indices > 0)
+        {
+            command.count = indices;
+            command.indexType = GL_UNSIGNED_INT;
+        }
+        command.vertexArray = vertexArrayId;
+        return command;
+    }
+
+    void MeshBuffers::release()
+    {
+        if (vertexArrayId)
+        {
+            glDeleteVertexArrays(1, &vertexArrayId);
+            glDeleteBuffers(1, &vertexBufferId);
+            if (indexBufferId)
+            {
+                glDeleteBuffers(1, &indexBufferId);
+            }
+        }
+        vertexArrayId = 0;
+        vertexBufferId = 0;
+        indexBufferId = 0;
+    }
+}
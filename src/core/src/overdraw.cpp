@@ -0,0 +1,168 @@
+#include <core/overdraw.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+#include <core/log.hpp>
+
+namespace core
+{
+    namespace
+    {
+        // Black, blue, green, yellow, red.
+        constexpr unsigned char Palette[][3] = {{0, 0, 0}, {0, 64, 255}, {0, 200, 64}, {255, 230, 0}, {255, 32, 0}};
+        constexpr std::size_t PaletteSize = sizeof(Palette) / sizeof(Palette[0]);
+
+        void heat(float count, unsigned char *color)
+        {
+            const float position = std::clamp(count, .0f, static_cast<float>(PaletteSize - 1));
+            const std::size_t low = static_cast<std::size_t>(position);
+            const std::size_t high = std::min(low + 1, PaletteSize - 1);
+            const float blend = position - low;
+            for (int channel_n = 0; channel_n < 3; channel_n++)
+            {
+                color[channel_n] = static_cast<unsigned char>(Palette[low][channel_n] * (1 - blend) + Palette[high][channel_n] * blend);
+            }
+            color[3] = 255;
+        }
+    }
+
+    Overdraw::Overdraw()
+    {
+        glGenFramebuffers(1, &heatmapFramebuffer);
+        glGenTextures(1, &heatmapTexture);
+    }
+
+    Overdraw::~Overdraw()
+    {
+        glDeleteFramebuffers(1, &heatmapFramebuffer);
+        glDeleteTextures(1, &heatmapTexture);
+    }
+
+    void Overdraw::resize(int width, int height)
+    {
+        values.resize(static_cast<std::size_t>(width) * height);
+        colors.resize(values.size() * 4);
+
+        // The heatmap follows the counts target's storage.
+        if (counts && !counts->resize(width, height))
+        {
+            return;
+        }
+        if (!counts)
+        {
+            counts = std::make_unique<RenderTarget>(width, height, GL_R32F);
+        }
+
+        glBindTexture(GL_TEXTURE_2D, heatmapTexture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, counts->storageWidth(), counts->storageHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, heatmapFramebuffer);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, heatmapTexture, 0);
+    }
+
+    void Overdraw::begin()
+    {
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &target);
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        if (!counts || counts->width() != viewport[2] || counts->height() != viewport[3])
+        {
+            resize(viewport[2], viewport[3]);
+        }
+
+        counts->bind();
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+    }
+
+    OverdrawStats Overdraw::end()
+    {
+        glDisable(GL_BLEND);
+
+        const int width = counts->width();
+        const int height = counts->height();
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, counts->framebuffer());
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        glReadPixels(0, 0, width, height, GL_RED, GL_FLOAT, values.data());
+
+        OverdrawStats stats;
+        std::uint64_t fragments = 0;
+        std::uint64_t covered = 0;
+        for (std::size_t pixel_n = 0; pixel_n < values.size(); pixel_n++)
+        {
+            const std::uint32_t count = static_cast<std::uint32_t>(std::lround(values[pixel_n]));
+            fragments += count;
+            covered += count > 0;
+            stats.maximum = std::max(stats.maximum, count);
+            stats.histogram[std::min<std::size_t>(count, stats.histogram.size() - 1)]++;
+            heat(values[pixel_n], &colors[pixel_n * 4]);
+        }
+        stats.average = values.empty() ? 0 : static_cast<double>(fragments) / values.size();
+        stats.coveredAverage = covered ? static_cast<double>(fragments) / covered : 0;
+
+        glBindTexture(GL_TEXTURE_2D, heatmapTexture);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, colors.data());
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, heatmapFramebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+        glBlitFramebuffer(0, 0, width, height, viewport[0], viewport[1], viewport[0] + width, viewport[1] + height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+        frames++;
+        totals.average += stats.average;
+        totals.coveredAverage += stats.coveredAverage;
+        totals.maximum = std::max(totals.maximum, stats.maximum);
+        for (std::size_t bucket_n = 0; bucket_n < stats.histogram.size(); bucket_n++)
+        {
+            totals.histogram[bucket_n] += stats.histogram[bucket_n];
+        }
+        if (frames == ReportInterval)
+        {
+            report();
+        }
+        return stats;
+    }
+
+    void Overdraw::report()
+    {
+        if (frames == 0)
+        {
+            return;
+        }
+
+        std::uint64_t pixels = 0;
+        for (std::uint64_t count : totals.histogram)
+        {
+            pixels += count;
+        }
+        std::string histogram;
+        for (std::size_t bucket_n = 0; bucket_n < totals.histogram.size(); bucket_n++)
+        {
+            char bucket[32];
+            std::snprintf(
+                bucket,
+                sizeof(bucket),
+                "%s%zu%s %.1f%%",
+                bucket_n ? ", " : "",
+                bucket_n,
+                bucket_n + 1 == totals.histogram.size() ? "+" : "",
+                100.0 * totals.histogram[bucket_n] / pixels);
+            histogram += bucket;
+        }
+
+        log::info(
+            "overdraw: {} fragments per pixel, {} per covered pixel, max {}; pixels drawn {}",
+            totals.average / frames,
+            totals.coveredAverage / frames,
+            totals.maximum,
+            histogram);
+
+        frames = 0;
+        totals = {};
+    }
+}
@@ -0,0 +1,80 @@
+#include <core/pipeline_statistics.hpp>
+
+#include <core/gl.hpp>
+
+namespace core
+{
+    PipelineStatistics::PipelineStatistics()
+    {
+        if (gl::extensions().pipelineStatistics)
+        {
+            targets = {
+                GL_VERTICES_SUBMITTED,
+                GL_PRIMITIVES_SUBMITTED,
+                GL_VERTEX_SHADER_INVOCATIONS,
+                GL_CLIPPING_INPUT_PRIMITIVES,
+                GL_FRAGMENT_SHADER_INVOCATIONS};
+        }
+        else
+        {
+            targets = {GL_PRIMITIVES_GENERATED, GL_SAMPLES_PASSED};
+        }
+        queries.resize(targets.size());
+        glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+    }
+
+    PipelineStatistics::~PipelineStatistics()
+    {
+        glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+    }
+
+    void PipelineStatistics::begin()
+    {
+        for (std::size_t query_n = 0; query_n < queries.size(); query_n++)
+        {
+            glBeginQuery(targets[query_n], queries[query_n]);
+        }
+    }
+
+    void PipelineStatistics::end()
+    {
+        for (GLenum target : targets)
+        {
+            glEndQuery(target);
+        }
+    }
+
+    PipelineCounts PipelineStatistics::read() const
+    {
+        PipelineCounts counts;
+        counts.exact = targets.size() > 2;
+        for (std::size_t query_n = 0; query_n < queries.size(); query_n++)
+        {
+            GLuint64 value = 0;
+            glGetQueryObjectui64v(queries[query_n], GL_QUERY_RESULT, &value);
+            switch (targets[query_n])
+            {
+            case GL_VERTICES_SUBMITTED:
+                counts.verticesSubmitted = value;
+                break;
+            case GL_PRIMITIVES_SUBMITTED:
+                counts.primitivesSubmitted = value;
+                break;
+            case GL_VERTEX_SHADER_INVOCATIONS:
+                counts.vertexShaderInvocations = value;
+                break;
+            case GL_CLIPPING_INPUT_PRIMITIVES:
+            case GL_PRIMITIVES_GENERATED:
+                counts.primitives = value;
+                break;
+            case GL_FRAGMENT_SHADER_INVOCATIONS:
+                counts.fragmentShaderInvocations = value;
+                break;
+            case GL_SAMPLES_PASSED:
+                counts.samplesPassed = value;
+                break;
+            }
+        }
+        return counts;
+    }
+}
@@ -0,0 +1,211 @@
+#include <core/profile.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <core/log.hpp>
+
+namespace core::profile
+{
+    namespace
+    {
+        constexpr std::size_t ChunkSize = 4096;
+        constexpr std::size_t MaxChunks = 256;
+    }
+
+    namespace detail
+    {
+        // Single producer (the owning thread, through its Cursor); readers
+        // only look at the first `count` events, which are never written
+        // again.
+        class ThreadBuffer
+        {
+        public:
+            explicit ThreadBuffer(std::uint32_t index) : index(index)
+            {
+            }
+
+            // Points `cursor` at the next chunk; false once all are full.
+            bool grow(Cursor &cursor)
+            {
+                const std::size_t chunk = cursor.count / ChunkSize;
+                if (chunk == MaxChunks)
+                {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                // Left uninitialized; events are only read below `count`.
+                chunks[chunk].reset(new Event[ChunkSize]);
+                cursor.next = chunks[chunk].get();
+                cursor.end = cursor.next + ChunkSize;
+                return true;
+            }
+
+            template <typename Visitor>
+            void visit(Visitor &&visitor) const
+            {
+                const std::size_t recorded = count.load(std::memory_order_acquire);
+                for (std::size_t event_n = 0; event_n < recorded; event_n++)
+                {
+                    visitor(chunks[event_n / ChunkSize][event_n % ChunkSize]);
+                }
+            }
+
+            const std::uint32_t index;
+            std::atomic<std::uint64_t> dropped{0};
+            std::atomic<std::size_t> count{0};
+
+        private:
+            std::unique_ptr<Event[]> chunks[MaxChunks];
+        };
+    }
+
+    namespace
+    {
+        // Buffers outlive their threads so a trace written at exit still has
+        // the zones of finished workers.
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<detail::ThreadBuffer>> buffers;
+        };
+
+        Registry &registry()
+        {
+            static Registry instance;
+            return instance;
+        }
+
+        detail::ThreadBuffer *registerThread()
+        {
+            Registry &registry = profile::registry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.buffers.push_back(std::make_unique<detail::ThreadBuffer>(static_cast<std::uint32_t>(registry.buffers.size())));
+            return registry.buffers.back().get();
+        }
+
+        struct Calibration
+        {
+            std::int64_t ticks;
+            Clock::time_point time;
+        };
+
+        Calibration calibrate()
+        {
+            return {detail::now(), Clock::now()};
+        }
+
+        const Calibration captureAtLoad = calibrate();
+
+#ifdef CORE_PROFILE
+        void writeString(std::FILE *file, const char *text)
+        {
+            std::fputc('"', file);
+            for (const char *cursor = text; *cursor; cursor++)
+            {
+                if (*cursor == '"' || *cursor == '\\')
+                {
+                    std::fputc('\\', file);
+                }
+                std::fputc(*cursor, file);
+            }
+            std::fputc('"', file);
+        }
+#endif
+    }
+
+    namespace detail
+    {
+        void record(const char *name, std::int64_t begin, std::int64_t end)
+        {
+            Cursor &current = cursor;
+            if (!current.buffer)
+            {
+                current.buffer = registerThread();
+                current.published = &current.buffer->count;
+            }
+            if (current.next == current.end && !current.buffer->grow(current))
+            {
+                return;
+            }
+            *current.next++ = {name, begin, end};
+            current.published->store(++current.count, std::memory_order_release);
+        }
+    }
+
+    bool writeChromeTrace(const std::string &path)
+    {
+#ifndef CORE_PROFILE
+        log::warning("not writing {}: built without CORE_PROFILE", path);
+        return false;
+#else
+        std::FILE *file = std::fopen(path.c_str(), "w");
+        if (!file)
+        {
+            log::warning("cannot write trace {}", path);
+            return false;
+        }
+
+        // Ticks map linearly onto the time between library load and now.
+        const Calibration end = calibrate();
+        const double microseconds = std::chrono::duration<double, std::micro>(end.time - captureAtLoad.time).count();
+        const double toMicroseconds = microseconds / std::max<std::int64_t>(end.ticks - captureAtLoad.ticks, 1);
+        const double offset = std::chrono::duration<double, std::micro>(captureAtLoad.time - startupTime()).count();
+        std::size_t events = 0;
+        std::uint64_t dropped = 0;
+
+        Registry &registry = profile::registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::fputs("{\"traceEvents\":[\n", file);
+        for (const std::unique_ptr<detail::ThreadBuffer> &buffer : registry.buffers)
+        {
+            std::fprintf(
+                file,
+                "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"T%u\"}}",
+                events++ ? ",\n" : "",
+                buffer->index,
+                buffer->index);
+            dropped += buffer->dropped.load(std::memory_order_relaxed);
+            buffer->visit(
+                [&](const detail::Event &event)
+                {
+                    std::fputs(",\n{\"name\":", file);
+                    writeString(file, event.name);
+                    std::fprintf(
+                        file,
+                        ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                        buffer->index,
+                        offset + (event.begin - captureAtLoad.ticks) * toMicroseconds,
+                        (event.end - event.begin) * toMicroseconds);
+                    events++;
+                });
+        }
+        std::fprintf(file, "\n],\"otherData\":{\"droppedZones\":%llu}}\n", static_cast<unsigned long long>(dropped));
+
+        if (std::fclose(file) != 0)
+        {
+            log::warning("cannot write trace {}", path);
+            return false;
+        }
+        log::info("wrote {} zones to {}, {} dropped", events - registry.buffers.size(), path, dropped);
+        return true;
+#endif
+    }
+
+    std::uint64_t droppedCount()
+    {
+        Registry &registry = profile::registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::uint64_t total = 0;
+        for (const std::unique_ptr<detail::ThreadBuffer> &buffer : registry.buffers)
+        {
+            total += buffer->dropped.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+}
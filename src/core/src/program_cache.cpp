@@ -0,0 +1,180 @@
+#include <core/program_cache.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+#include <core/gl.hpp>
+#include <core/hash.hpp>
+#include <core/log.hpp>
+
+namespace core
+{
+    namespace
+    {
+        constexpr char Magic[8] = {'G', 'L', 'P', 'R', 'O', 'G', 'B', 'N'};
+        constexpr std::uint32_t FormatVersion = 1;
+        // Far above any real program binary; longer entries are corrupt.
+        constexpr std::uint64_t MaxBinaryLength = 64ull << 20;
+
+        struct EntryHeader
+        {
+            char magic[8];
+            std::uint32_t version;
+            GLenum binaryFormat;
+            std::uint64_t key;
+            std::uint64_t length;
+        };
+
+        std::string_view glString(GLenum name)
+        {
+            const GLubyte *value = glGetString(name);
+            return value ? reinterpret_cast<const char *>(value) : "";
+        }
+    }
+
+    ProgramCache::ProgramCache(std::filesystem::path directory) : directory(std::move(directory))
+    {
+        driver = fnv1a64(glString(GL_VENDOR));
+        driver = fnv1a64(glString(GL_RENDERER), driver);
+        driver = fnv1a64(glString(GL_VERSION), driver);
+    }
+
+    std::filesystem::path ProgramCache::defaultDirectory()
+    {
+        if (const char *cacheHome = std::getenv("XDG_CACHE_HOME"); cacheHome && *cacheHome)
+        {
+            return std::filesystem::path(cacheHome) / "opengl-learn";
+        }
+        if (const char *home = std::getenv("HOME"); home && *home)
+        {
+            return std::filesystem::path(home) / ".cache" / "opengl-learn";
+        }
+        return std::filesystem::temp_directory_path() / "opengl-learn";
+    }
+
+    bool ProgramCache::enabled() const
+    {
+        return gl::extensions().programBinary && !directory.empty();
+    }
+
+    std::uint64_t ProgramCache::key(const EmbeddedShader &vertex, const EmbeddedShader &fragment, bool spirv) const
+    {
+        std::uint64_t key = hashCombine(hashCombine(driver, vertex.hash), fragment.hash);
+        key = hashCombine(key, spirv);
+        // One module specialized differently is a different program.
+        key = hashCombine(key, vertex.features & vertex.specialized);
+        return hashCombine(key, fragment.features & fragment.specialized);
+    }
+
+    GLuint ProgramCache::load(std::uint64_t key) const
+    {
+        if (!enabled())
+        {
+            return 0;
+        }
+
+        std::ifstream file(entryPath(key), std::ios::binary);
+        if (!file)
+        {
+            return 0;
+        }
+        std::error_code sizeError;
+        const std::uintmax_t fileSize = std::filesystem::file_size(entryPath(key), sizeError);
+
+        EntryHeader header;
+        std::vector<char> binary;
+        // The length comes from disk, so it must match what the file holds
+        // before anything is allocated for it.
+        if (file.read(reinterpret_cast<char *>(&header), sizeof(header)) &&
+            std::memcmp(header.magic, Magic, sizeof(Magic)) == 0 &&
+            header.version == FormatVersion &&
+            header.key == key &&
+            !sizeError &&
+            header.length <= MaxBinaryLength &&
+            header.length == fileSize - sizeof(header))
+        {
+            binary.resize(header.length);
+            file.read(binary.data(), binary.size());
+        }
+        if (binary.empty() || !file)
+        {
+            log::warning("program cache: discarding malformed entry {}", entryPath(key).string());
+            std::error_code ignored;
+            std::filesystem::remove(entryPath(key), ignored);
+            return 0;
+        }
+
+        GLuint program = glCreateProgram();
+        gl::programBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+        GLint status = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (!status)
+        {
+            // Usually a driver update that kept the version string.
+            log::warning("program cache: driver rejected {}", entryPath(key).string());
+            glDeleteProgram(program);
+            std::error_code ignored;
+            std::filesystem::remove(entryPath(key), ignored);
+            return 0;
+        }
+        return program;
+    }
+
+    void ProgramCache::store(std::uint64_t key, GLuint program) const
+    {
+        if (!enabled())
+        {
+            return;
+        }
+
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+        {
+            return;
+        }
+
+        EntryHeader header;
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.version = FormatVersion;
+        header.key = key;
+        std::vector<char> binary(length);
+        GLsizei written = 0;
+        gl::getProgramBinary(program, length, &written, &header.binaryFormat, binary.data());
+        header.length = written;
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        const std::filesystem::path path = entryPath(key);
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            file.write(binary.data(), written);
+            if (!file)
+            {
+                log::warning("program cache: could not write {}", temporary.string());
+                return;
+            }
+        }
+        // Readers never see a partially written entry.
+        std::filesystem::rename(temporary, path, error);
+        if (error)
+        {
+            log::warning("program cache: could not write {}: {}", path.string(), error.message());
+        }
+    }
+
+    std::filesystem::path ProgramCache::entryPath(std::uint64_t key) const
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+        return directory / name;
+    }
+}
@@ -0,0 +1,163 @@
+#include <core/program_registry.hpp>
+
+#include <algorithm>
+
+#include <core/hash.hpp>
+#include <core/log.hpp>
+
+namespace core
+{
+    namespace
+    {
+        using Table = std::vector<std::pair<std::string, GLint>>;
+
+        GLint find(const Table &table, std::string_view name, GLint missing)
+        {
+            auto found = std::lower_bound(
+                table.begin(),
+                table.end(),
+                name,
+                [](const std::pair<std::string, GLint> &entry, std::string_view key) { return entry.first < key; });
+            return found != table.end() && found->first == name ? found->second : missing;
+        }
+
+        void sort(Table &table)
+        {
+            std::sort(table.begin(), table.end());
+        }
+
+        // Arrays are reported as "name[0]"; make them reachable as "name" too.
+        void addName(Table &table, std::string name, GLint value)
+        {
+            const std::size_t bracket = name.find('[');
+            if (bracket != std::string::npos && name.compare(bracket, std::string::npos, "[0]") == 0)
+            {
+                table.emplace_back(name.substr(0, bracket), value);
+            }
+            table.emplace_back(std::move(name), value);
+        }
+    }
+
+    GLint Program::uniformLocation(std::string_view name) const
+    {
+        return find(uniforms, name, -1);
+    }
+
+    GLint Program::attributeLocation(std::string_view name) const
+    {
+        return find(attributes, name, -1);
+    }
+
+    GLuint Program::uniformBlockIndex(std::string_view name) const
+    {
+        return static_cast<GLuint>(find(uniformBlocks, name, static_cast<GLint>(GL_INVALID_INDEX)));
+    }
+
+    void Program::reflect()
+    {
+        GLint count = 0;
+        GLint maxLength = 0;
+        std::vector<char> name;
+
+        glGetProgramiv(programId, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(programId, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        name.resize(std::max(maxLength, 1));
+        for (GLint uniform_n = 0; uniform_n < count; uniform_n++)
+        {
+            GLint size;
+            GLenum type;
+            glGetActiveUniform(programId, uniform_n, static_cast<GLsizei>(name.size()), nullptr, &size, &type, name.data());
+            // Members of uniform blocks have no location.
+            const GLint location = glGetUniformLocation(programId, name.data());
+            if (location >= 0)
+            {
+                addName(uniforms, name.data(), location);
+            }
+        }
+
+        glGetProgramiv(programId, GL_ACTIVE_ATTRIBUTES, &count);
+        glGetProgramiv(programId, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLength);
+        name.resize(std::max(maxLength, 1));
+        for (GLint attribute_n = 0; attribute_n < count; attribute_n++)
+        {
+            GLint size;
+            GLenum type;
+            glGetActiveAttrib(programId, attribute_n, static_cast<GLsizei>(name.size()), nullptr, &size, &type, name.data());
+            addName(attributes, name.data(), glGetAttribLocation(programId, name.data()));
+        }
+
+        glGetProgramiv(programId, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+        glGetProgramiv(programId, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &maxLength);
+        name.resize(std::max(maxLength, 1));
+        for (GLint block_n = 0; block_n < count; block_n++)
+        {
+            glGetActiveUniformBlockName(programId, block_n, static_cast<GLsizei>(name.size()), nullptr, name.data());
+            uniformBlocks.emplace_back(name.data(), block_n);
+        }
+
+        sort(uniforms);
+        sort(attributes);
+        sort(uniformBlocks);
+    }
+
+    std::size_t ProgramRegistry::KeyHash::operator()(const Key &key) const
+    {
+        return hashCombine(hashCombine(hashCombine(Fnv1aOffset, key.vertex), key.fragment), key.defines);
+    }
+
+    ProgramRegistry::ProgramRegistry(const ProgramCache *cache) : cache(cache)
+    {
+    }
+
+    ProgramRegistry::~ProgramRegistry()
+    {
+        clear();
+    }
+
+    void ProgramRegistry::prefetch(const EmbeddedShader &vertex, const EmbeddedShader &requested, std::uint64_t defines)
+    {
+        const EmbeddedShader &fragment = replacement ? *replacement : requested;
+        Entry &entry = entries[{vertex.hash, fragment.hash, defines}];
+        if (!entry.program && !entry.pending && !entry.failed)
+        {
+            entry.pending = std::make_unique<PendingProgram>(vertex, fragment, cache);
+        }
+    }
+
+    ProgramHandle ProgramRegistry::acquire(const EmbeddedShader &vertex, const EmbeddedShader &requested, std::uint64_t defines)
+    {
+        prefetch(vertex, requested, defines);
+
+        const EmbeddedShader &fragment = replacement ? *replacement : requested;
+        Entry &entry = entries[{vertex.hash, fragment.hash, defines}];
+        if (entry.pending)
+        {
+            GLuint programId = entry.pending->finish();
+            entry.pending.reset();
+            if (programId)
+            {
+                entry.program = std::make_shared<Program>();
+                entry.program->programId = programId;
+                entry.program->reflect();
+            }
+            else
+            {
+                entry.failed = true;
+            }
+        }
+        return entry.program;
+    }
+
+    void ProgramRegistry::clear()
+    {
+        for (auto &[key, entry] : entries)
+        {
+            if (entry.program)
+            {
+                glDeleteProgram(entry.program->programId);
+                entry.program->programId = 0;
+            }
+        }
+        entries.clear();
+    }
+}
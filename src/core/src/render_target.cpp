@@ -0,0 +1,83 @@
+#include <core/render_target.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <core/log.hpp>
+
+namespace core
+{
+    RenderTarget::RenderTarget(int width, int height, GLenum format) : format(format), targetWidth(width), targetHeight(height)
+    {
+        glGenRenderbuffers(1, &colorId);
+        glGenFramebuffers(1, &framebufferId);
+        allocate(width, height);
+    }
+
+    RenderTarget::~RenderTarget()
+    {
+        glDeleteFramebuffers(1, &framebufferId);
+        glDeleteRenderbuffers(1, &colorId);
+    }
+
+    bool RenderTarget::resize(int width, int height)
+    {
+        targetWidth = width;
+        targetHeight = height;
+        if (width <= allocatedWidth && height <= allocatedHeight)
+        {
+            return false;
+        }
+
+        auto step = [](int size) { return (size + SizeStep - 1) / SizeStep * SizeStep; };
+        allocate(std::max(step(width), allocatedWidth), std::max(step(height), allocatedHeight));
+        log::debug("render target storage grown to {}x{} for {}x{}", allocatedWidth, allocatedHeight, width, height);
+        return true;
+    }
+
+    void RenderTarget::allocate(int width, int height)
+    {
+        allocatedWidth = width;
+        allocatedHeight = height;
+        glBindRenderbuffer(GL_RENDERBUFFER, colorId);
+        glRenderbufferStorage(GL_RENDERBUFFER, format, width, height);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorId);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        {
+            log::error("render target {}x{} is incomplete", width, height);
+        }
+    }
+
+    void RenderTarget::bind() const
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, framebufferId);
+        glViewport(0, 0, targetWidth, targetHeight);
+    }
+
+    bool RenderTarget::savePpm(const std::filesystem::path &path) const
+    {
+        const std::size_t row = static_cast<std::size_t>(targetWidth) * 3;
+        std::vector<unsigned char> pixels(row * targetHeight);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, framebufferId);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, targetWidth, targetHeight, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+        std::FILE *file = std::fopen(path.string().c_str(), "wb");
+        if (!file)
+        {
+            log::error("cannot write {}", path.string());
+            return false;
+        }
+        std::fprintf(file, "P6\n%d %d\n255\n", targetWidth, targetHeight);
+        // GL rows start at the bottom.
+        for (int row_n = targetHeight - 1; row_n >= 0; row_n--)
+        {
+            std::fwrite(pixels.data() + row_n * row, 1, row, file);
+        }
+        return std::fclose(file) == 0;
+    }
+}
@@ -0,0 +1,299 @@
+#include <core/shader.hpp>
+
+#include <cctype>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <core/gl.hpp>
+#include <core/log.hpp>
+#include <core/profile.hpp>
+
+namespace core
+{
+    namespace
+    {
+        GLuint submitSpirv(GLenum type, const EmbeddedShader &shader)
+        {
+            GLuint indices[32];
+            GLuint values[32];
+            GLuint count = 0;
+            for (GLuint feature_n = 0; feature_n < 32; feature_n++)
+            {
+                if ((shader.specialized >> feature_n) & 1)
+                {
+                    indices[count] = feature_n;
+                    values[count] = (shader.features >> feature_n) & 1;
+                    count++;
+                }
+            }
+
+            GLuint id = glCreateShader(type);
+            gl::shaderBinary(1, &id, GL_SHADER_BINARY_FORMAT_SPIR_V, shader.spirv, static_cast<GLsizei>(shader.spirvWords * sizeof(std::uint32_t)));
+            gl::specializeShader(id, "main", count, indices, values);
+            return id;
+        }
+
+        GLuint submitShader(GLenum type, const EmbeddedShader &shader)
+        {
+            std::vector<const GLchar *> sources(shader.chunkCount);
+            std::vector<GLint> lengths(shader.chunkCount);
+            for (std::size_t chunk_n = 0; chunk_n < shader.chunkCount; chunk_n++)
+            {
+                sources[chunk_n] = shader.chunks[chunk_n].data();
+                lengths[chunk_n] = static_cast<GLint>(shader.chunks[chunk_n].size());
+            }
+            GLuint id = glCreateShader(type);
+            glShaderSource(id, static_cast<GLsizei>(shader.chunkCount), sources.data(), lengths.data());
+            glCompileShader(id);
+            return id;
+        }
+
+        // Mesa honours #line numbers but reports messages past the parser
+        // (an undeclared name, a bad constructor) as source 0; file names
+        // are then only certain for shaders without includes.
+        bool reportsSourceNumbers()
+        {
+            static const bool reports = []
+            {
+                const GLchar *source = "#version 330 core\n#line 1 7\nvoid main() { undeclared; }\n";
+                GLuint id = glCreateShader(GL_FRAGMENT_SHADER);
+                glShaderSource(id, 1, &source, nullptr);
+                glCompileShader(id);
+                char infoLog[256] = {0};
+                glGetShaderInfoLog(id, sizeof(infoLog), nullptr, infoLog);
+                glDeleteShader(id);
+                return std::strstr(infoLog, "7:") || std::strstr(infoLog, "7(");
+            }();
+            return reports;
+        }
+
+        // Messages start with the source string number, after an optional
+        // "ERROR: " on some drivers ("0:12(3): error", "0(12) : error",
+        // "ERROR: 0:12: ..."); shader_embed's #line directives make that a
+        // file index, replaced here by the file's name.
+        std::string nameSources(const char *infoLog, const EmbeddedShader &shader)
+        {
+            bool unknown = false;
+            std::string named;
+            for (const char *line = infoLog; *line;)
+            {
+                const char *prefix = line;
+                for (const char *severity : {"ERROR: ", "WARNING: "})
+                {
+                    if (std::string_view(line).rfind(severity, 0) == 0)
+                    {
+                        prefix = line + std::char_traits<char>::length(severity);
+                    }
+                }
+                const char *digits = prefix;
+                std::size_t file = 0;
+                while (std::isdigit(static_cast<unsigned char>(*digits)))
+                {
+                    file = file * 10 + (*digits++ - '0');
+                }
+
+                named.append(line, prefix);
+                const bool numbered = digits > prefix && (*digits == ':' || *digits == '(') && file < shader.fileCount;
+                if (numbered && file == 0 && shader.fileCount > 1 && !reportsSourceNumbers())
+                {
+                    unknown = true;
+                    named.append(prefix, digits);
+                }
+                else if (numbered)
+                {
+                    named += shader.files[file];
+                }
+                else
+                {
+                    named.append(prefix, digits);
+                }
+
+                const char *end = digits;
+                while (*end && *end != '\n')
+                {
+                    end++;
+                }
+                if (*end)
+                {
+                    end++;
+                }
+                named.append(digits, end);
+                line = end;
+            }
+
+            if (unknown)
+            {
+                named += "(source 0 may be any of";
+                for (std::size_t file_n = 0; file_n < shader.fileCount; file_n++)
+                {
+                    named += std::string(file_n ? ", " : " ") + shader.files[file_n];
+                }
+                named += ")\n";
+            }
+            return named;
+        }
+
+        void reportShaderFailure(GLuint id, const EmbeddedShader &shader, const char *message)
+        {
+            GLint status;
+            glGetShaderiv(id, GL_COMPILE_STATUS, &status);
+            if (!status)
+            {
+                char infoLog[512] = {0};
+                glGetShaderInfoLog(id, sizeof(infoLog), nullptr, infoLog);
+                log::error("{}{}", message, nameSources(infoLog, shader));
+            }
+        }
+    }
+
+    PendingProgram::PendingProgram(
+        const EmbeddedShader &vertex,
+        const EmbeddedShader &fragment,
+        const ProgramCache *cache,
+        ShaderFormat format)
+        : vertexSource(&vertex), fragmentSource(&fragment), cache(cache && cache->enabled() ? cache : nullptr)
+    {
+        CORE_PROFILE_ZONE("shader compile");
+        submitted = Clock::now();
+
+        if (format == ShaderFormat::Spirv && gl::extensions().spirv && vertex.spirv && fragment.spirv)
+        {
+            submittedFormat = ShaderFormat::Spirv;
+        }
+
+        if (this->cache)
+        {
+            cacheKey = this->cache->key(vertex, fragment, submittedFormat == ShaderFormat::Spirv);
+            programId = this->cache->load(cacheKey);
+            if (programId)
+            {
+                fromCache = true;
+                return;
+            }
+        }
+
+        if (gl::extensions().parallelShaderCompile)
+        {
+            // Let the driver pick as many compiler threads as it wants.
+            gl::maxShaderCompilerThreads(0xFFFFFFFF);
+        }
+
+        if (submittedFormat == ShaderFormat::Spirv)
+        {
+            vertexShaderId = submitSpirv(GL_VERTEX_SHADER, vertex);
+            fragmentShaderId = submitSpirv(GL_FRAGMENT_SHADER, fragment);
+        }
+        else
+        {
+            vertexShaderId = submitShader(GL_VERTEX_SHADER, vertex);
+            fragmentShaderId = submitShader(GL_FRAGMENT_SHADER, fragment);
+        }
+
+        programId = glCreateProgram();
+        glAttachShader(programId, vertexShaderId);
+        glAttachShader(programId, fragmentShaderId);
+        if (this->cache)
+        {
+            gl::programParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+        glLinkProgram(programId);
+    }
+
+    PendingProgram::~PendingProgram()
+    {
+        if (vertexShaderId)
+        {
+            glDeleteShader(vertexShaderId);
+        }
+        if (fragmentShaderId)
+        {
+            glDeleteShader(fragmentShaderId);
+        }
+        if (programId)
+        {
+            glDeleteProgram(programId);
+        }
+    }
+
+    bool PendingProgram::ready() const
+    {
+        if (fromCache)
+        {
+            return true;
+        }
+        if (!gl::extensions().parallelShaderCompile)
+        {
+            return false;
+        }
+        GLint completed = GL_FALSE;
+        glGetProgramiv(programId, GL_COMPLETION_STATUS_KHR, &completed);
+        return completed == GL_TRUE;
+    }
+
+    GLuint PendingProgram::finish()
+    {
+        CORE_PROFILE_ZONE("shader link");
+        const Clock::time_point finishing = Clock::now();
+        if (fromCache)
+        {
+            log::info("shader program {}: loaded from program cache in {} ms", programId, millisecondsBetween(submitted, finishing));
+            GLuint result = programId;
+            programId = 0;
+            return result;
+        }
+
+        const bool completedInBackground = ready();
+
+        GLint status;
+        glGetProgramiv(programId, GL_LINK_STATUS, &status);
+        const Clock::time_point linked = Clock::now();
+
+        if (!status)
+        {
+            reportFailure();
+        }
+
+        glDetachShader(programId, vertexShaderId);
+        glDetachShader(programId, fragmentShaderId);
+        glDeleteShader(vertexShaderId);
+        glDeleteShader(fragmentShaderId);
+        vertexShaderId = 0;
+        fragmentShaderId = 0;
+
+        if (!status)
+        {
+            glDeleteProgram(programId);
+            programId = 0;
+        }
+
+        if (programId && cache)
+        {
+            cache->store(cacheKey, programId);
+        }
+
+        log::info(
+            "shader program {}: compiled from {} in {} ms, {} ms of startup work overlapped compilation, blocked {} ms{}",
+            programId,
+            submittedFormat == ShaderFormat::Spirv ? "spir-v" : "source",
+            millisecondsBetween(submitted, linked),
+            millisecondsBetween(submitted, finishing),
+            millisecondsBetween(finishing, linked),
+            completedInBackground ? " (compiled in background)" : "");
+
+        GLuint result = programId;
+        programId = 0;
+        return result;
+    }
+
+    void PendingProgram::reportFailure()
+    {
+        reportShaderFailure(vertexShaderId, *vertexSource, "ERROR::SHADER::VERTEX::COMPILATION_FAILED");
+        reportShaderFailure(fragmentShaderId, *fragmentSource, "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED");
+
+        char infoLog[512] = {0};
+        glGetProgramInfoLog(programId, sizeof(infoLog), nullptr, infoLog);
+        log::error("ERROR::SHADER::PROGRAM::LINKING_FAILED{}", infoLog);
+    }
+}
@@ -0,0 +1,100 @@
+#include <core/uniform_ring.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include <core/log.hpp>
+#include <core/profile.hpp>
+
+namespace core
+{
+    namespace
+    {
+        std::size_t alignUp(std::size_t value, std::size_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    UniformRing::UniformRing(std::size_t regionSize, std::size_t regions) : fences(regions, nullptr)
+    {
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        offsetAlignment = std::max<std::size_t>(alignment, 1);
+
+        glGenBuffers(1, &bufferId);
+        allocate(regionSize);
+    }
+
+    UniformRing::~UniformRing()
+    {
+        for (GLsync fence : fences)
+        {
+            if (fence)
+            {
+                glDeleteSync(fence);
+            }
+        }
+        glDeleteBuffers(1, &bufferId);
+    }
+
+    void UniformRing::allocate(std::size_t size)
+    {
+        for (GLsync &fence : fences)
+        {
+            if (fence)
+            {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+        regionSize = alignUp(size, offsetAlignment);
+
+        // Fresh storage; draws still reading the old one keep it alive.
+        glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+        glBufferData(GL_UNIFORM_BUFFER, regionSize * fences.size(), nullptr, GL_STREAM_DRAW);
+    }
+
+    GLintptr UniformRing::upload(const void *data, std::size_t size)
+    {
+        CORE_PROFILE_ZONE("uniform upload");
+        if (size > regionSize)
+        {
+            log::debug("uniform ring grows from {} to {} bytes per region", regionSize, alignUp(size, offsetAlignment));
+            allocate(size);
+        }
+
+        region = (region + 1) % fences.size();
+        GLsync &fence = fences[region];
+        if (fence)
+        {
+            glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+
+        const GLintptr offset = static_cast<GLintptr>(region * regionSize);
+        glBindBuffer(GL_UNIFORM_BUFFER, bufferId);
+        void *target = glMapBufferRange(
+            GL_UNIFORM_BUFFER,
+            offset,
+            static_cast<GLsizeiptr>(size),
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (target)
+        {
+            std::memcpy(target, data, size);
+            glUnmapBuffer(GL_UNIFORM_BUFFER);
+        }
+        return offset;
+    }
+
+    void UniformRing::retire()
+    {
+        GLsync &fence = fences[region];
+        if (fence)
+        {
+            glDeleteSync(fence);
+        }
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
@@ -1,147 +1,62 @@
-#include <iostream>
-#include <functional>
-#include <vector>
-#include <cmath>
 #include <cassert>
+#include <cstdint>
 
 #include <glad/glad.h>
-#include <GLFW/glfw3.h>
+
+#include <core/application.hpp>
+#include <core/mesh.hpp>
+#include <core/mesh_buffers.hpp>
 
 #include <shaders/basic_vertex.generated.hpp>
 #include <shaders/basic_fragment.generated.hpp>
 
-static void onFrameBufferSizeCallback(
-    GLFWwindow *window,
-    int width,
-    int height)
-{
-    glViewport(0, 0, width, height);
-}
+#define DIVISIONS 8
 
-static void onKeyCallback(
-    GLFWwindow *window,
-    int key,
-    int scancode,
-    int action,
-    int mods)
+class OptimizedCircleScene : public core::Scene
 {
-    std::cout << "Key callback: " << key << " action: " << action << std::endl;
-}
-
-int main(int, char **)
-{
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow *window = glfwCreateWindow(800, 600, "LearnOpenGL", nullptr, nullptr);
-    if (!window)
-    {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return EXIT_FAILURE;
-    }
-    glfwMakeContextCurrent(window);
-
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-    {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-        glfwTerminate();
-        return EXIT_FAILURE;
-    }
-
-    glfwSetFramebufferSizeCallback(window, onFrameBufferSizeCallback);
-    glfwSetKeyCallback(window, onKeyCallback);
-
-    #define DIVISIONS 8
-    #define CIRCLE (2 * M_PI)
-    #define ANGLE (CIRCLE / DIVISIONS)
-    std::vector<float> vertices = {.0f, .0f, .0f};
-    std::vector<unsigned int> indices;
-
-    for (size_t division_n = 0; division_n < DIVISIONS; division_n++)
-    {
-        float angle_n = division_n * ANGLE;
-
-        vertices.push_back(std::cos(angle_n));  // x
-        vertices.push_back(std::sin(angle_n));  // y
-        vertices.push_back(.0f);                // z
-
-        indices.push_back(0);                                       // center
-        indices.push_back(division_n + 1);                          // current xyz
-        indices.push_back(((division_n + 1) % DIVISIONS) + 1);      // next (expected) xyz
-    }
-
-    assert((DIVISIONS + 1) * 3 == vertices.size());
-    assert((DIVISIONS) * 3 == indices.size());
-
-    std::function<void(int)> verifyShaderCompilationStatus = [](unsigned int id)
+public:
+    bool setup(core::Application &application) override
     {
-        int status;
-        glGetShaderiv(id, GL_COMPILE_STATUS, &status);
-        if (!status)
+        const EmbeddedShader &vertexShader = basic_vertex_variants[basic_vertex_feature::TRANSFORM];
+        application.programs().prefetch(vertexShader, basic_fragment, basic_vertex_feature::TRANSFORM);
+
+        core::mesh::Mesh mesh = core::mesh::circleIndexed(DIVISIONS);
+        assert((DIVISIONS + 1) * 3 == mesh.vertices.size());
+        assert((DIVISIONS) * 3 == mesh.indices.size());
+        circle = core::MeshBuffers(mesh);
+
+        core::ProgramHandle program = application.programs().acquire(vertexShader, basic_fragment, basic_vertex_feature::TRANSFORM);
+        // SPIR-V programs come with the binding set and may not know block names.
+        const GLuint transformIndex = program ? program->uniformBlockIndex("Transform") : GL_INVALID_INDEX;
+        if (transformIndex != GL_INVALID_INDEX)
         {
-            char infoLog[512] = {0};
-            glGetShaderInfoLog(id, sizeof(infoLog), nullptr, infoLog);
-            std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED" << infoLog << std::endl;
+            glUniformBlockBinding(program->id(), transformIndex, uniforms::Transform::binding);
         }
-    };
-
-    unsigned int vertexShaderId;
-    vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShaderId, 1, &basic_vertex, nullptr);
-    glCompileShader(vertexShaderId);
-    verifyShaderCompilationStatus(vertexShaderId);
-
-    unsigned int fragmentShaderId;
-    fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShaderId, 1, &basic_fragment, nullptr);
-    glCompileShader(fragmentShaderId);
-    verifyShaderCompilationStatus(fragmentShaderId);
-
-    unsigned int shaderProgramId;
-    shaderProgramId = glCreateProgram();
-    glAttachShader(shaderProgramId, vertexShaderId);
-    glAttachShader(shaderProgramId, fragmentShaderId);
-    glLinkProgram(shaderProgramId);
-    glUseProgram(shaderProgramId);
-
-    glDeleteShader(vertexShaderId);
-    glDeleteShader(fragmentShaderId);
-
-    unsigned int vertexArrayObjectId;
-    glGenVertexArrays(1, &vertexArrayObjectId);
-    glBindVertexArray(vertexArrayObjectId);
-
-    unsigned int arrayBufferObjectId;
-    glGenBuffers(1, &arrayBufferObjectId);
-    glBindBuffer(GL_ARRAY_BUFFER, arrayBufferObjectId);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    unsigned int elementArrayBufferObjectId;
-    glGenBuffers(1, &elementArrayBufferObjectId);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementArrayBufferObjectId);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-
-#if 0
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-#endif
+        glUseProgram(program ? program->id() : 0);
+        return program != nullptr;
+    }
 
-    while (!glfwWindowShouldClose(window))
+    void build(core::FrameCommands &frame, std::uint64_t) override
     {
-        glClearColor(.2f, .3f, .3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-
-        glfwPollEvents();
-        glfwSwapBuffers(window);
+        // Identity: the block still goes through the ring, the circle stays put.
+        uniforms::Transform transform = {};
+        transform.model[0][0] = 1.0f;
+        transform.model[1][1] = 1.0f;
+        transform.model[2][2] = 1.0f;
+        transform.model[3][3] = 1.0f;
+
+        frame.clearColor = {.2f, .3f, .3f, 1.0f};
+        frame.uniforms.clear();
+        frame.uniformBindings = {frame.stage(uniforms::Transform::binding, transform)};
+        frame.draws = {circle.draw()};
+        frame.draws.back().label = "circle";
     }
 
-    glfwTerminate();
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+private:
+    core::MeshBuffers circle;
+};
+
+int main(int argc, char **argv)
+{
+    return core::runScene<OptimizedCircleScene>(argc, argv);
+}
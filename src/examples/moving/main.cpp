@@ -0,0 +1,125 @@
+#include <cmath>
+#include <cstdint>
+
+#include <glad/glad.h>
+
+#include <core/application.hpp>
+#include <core/mesh.hpp>
+#include <core/mesh_buffers.hpp>
+
+#include <shaders/basic_vertex.generated.hpp>
+#include <shaders/basic_fragment.generated.hpp>
+
+#define DIVISIONS 32
+
+// A small square circling over a static circle. Only the square moves, so
+// every frame reports the square's previous and current bounds as damage
+// and the rest of the screen keeps the previous frame.
+namespace
+{
+    constexpr float SquareScale = .1f;
+    constexpr float CircleScale = .5f;
+    constexpr float OrbitRadius = .75f;
+
+    void orbit(std::uint64_t frameIndex, float &x, float &y)
+    {
+        const float angle = frameIndex * .02f;
+        x = OrbitRadius * std::cos(angle);
+        y = OrbitRadius * std::sin(angle);
+    }
+
+    uniforms::Transform placed(float scale, float x, float y)
+    {
+        uniforms::Transform transform = {};
+        transform.model[0][0] = scale;
+        transform.model[1][1] = scale;
+        transform.model[2][2] = 1.0f;
+        transform.model[3][0] = x;
+        transform.model[3][1] = y;
+        transform.model[3][3] = 1.0f;
+        return transform;
+    }
+}
+
+class MovingSquareScene : public core::Scene
+{
+public:
+    bool setup(core::Application &application) override
+    {
+        const EmbeddedShader &vertexShader = basic_vertex_variants[basic_vertex_feature::TRANSFORM];
+        application.programs().prefetch(vertexShader, basic_fragment, basic_vertex_feature::TRANSFORM);
+
+        const core::mesh::Mesh squareMesh = {
+            {
+                .5f, .5f, .0f, // top right
+                .5f, -.5f, .0f, // bottom right
+                -.5f, -.5f, .0f, // bottom left
+                -.5f, .5f, .0f // top left
+            },
+            {
+                0, 1, 3, // first triangle
+                1, 2, 3 // second triangle
+            }};
+        square = core::MeshBuffers(squareMesh);
+        squareBounds = core::mesh::bounds(squareMesh);
+        circle = core::MeshBuffers(core::mesh::circleIndexed(DIVISIONS));
+
+        core::ProgramHandle program = application.programs().acquire(vertexShader, basic_fragment, basic_vertex_feature::TRANSFORM);
+        // SPIR-V programs come with the binding set and may not know block names.
+        const GLuint transformIndex = program ? program->uniformBlockIndex("Transform") : GL_INVALID_INDEX;
+        if (transformIndex != GL_INVALID_INDEX)
+        {
+            glUniformBlockBinding(program->id(), transformIndex, uniforms::Transform::binding);
+        }
+        glUseProgram(program ? program->id() : 0);
+        return program != nullptr;
+    }
+
+    void build(core::FrameCommands &frame, std::uint64_t frameIndex) override
+    {
+        float x;
+        float y;
+        orbit(frameIndex, x, y);
+
+        frame.clearColor = {.2f, .3f, .3f, 1.0f};
+        frame.uniforms.clear();
+        frame.uniformBindings.clear();
+        frame.draws = {circle.draw(), square.draw()};
+        frame.draws[0].label = "circle";
+        frame.draws[0].uniforms = frame.stage(uniforms::Transform::binding, placed(CircleScale, 0, 0));
+        frame.draws[1].label = "square";
+        frame.draws[1].uniforms = frame.stage(uniforms::Transform::binding, placed(SquareScale, x, y));
+
+        frame.partial = true;
+        frame.damage = {at(x, y)};
+        if (frameIndex > 0)
+        {
+            orbit(frameIndex - 1, x, y);
+            frame.damage.push_back(at(x, y));
+        }
+    }
+
+    bool animating() const override
+    {
+        return true;
+    }
+
+private:
+    core::mesh::Bounds at(float x, float y) const
+    {
+        return {
+            squareBounds.left * SquareScale + x,
+            squareBounds.bottom * SquareScale + y,
+            squareBounds.right * SquareScale + x,
+            squareBounds.top * SquareScale + y};
+    }
+
+    core::MeshBuffers square;
+    core::MeshBuffers circle;
+    core::mesh::Bounds squareBounds;
+};
+
+int main(int argc, char **argv)
+{
+    return core::runScene<MovingSquareScene>(argc, argv);
+}
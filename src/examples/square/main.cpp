@@ -1,134 +1,51 @@
-#include <iostream>
-#include <functional>
+#include <cstdint>
 
 #include <glad/glad.h>
-#include <GLFW/glfw3.h>
+
+#include <core/application.hpp>
+#include <core/mesh_buffers.hpp>
 
 #include <shaders/basic_vertex.generated.hpp>
 #include <shaders/basic_fragment.generated.hpp>
 
-static void onFrameBufferSizeCallback(
-    GLFWwindow *window,
-    int width,
-    int height)
-{
-    glViewport(0, 0, width, height);
-}
-
-static void onKeyCallback(
-    GLFWwindow *window,
-    int key,
-    int scancode,
-    int action,
-    int mods)
-{
-    std::cout << "Key callback: " << key << " action: " << action << std::endl;
-}
-
-int main(int, char **)
+class SquareScene : public core::Scene
 {
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow *window = glfwCreateWindow(800, 600, "LearnOpenGL", nullptr, nullptr);
-    if (!window)
+public:
+    bool setup(core::Application &application) override
     {
-        std::cout << "Failed to create GLFW window" << std::endl;
-        glfwTerminate();
-        return EXIT_FAILURE;
+        application.programs().prefetch(basic_vertex, basic_fragment);
+
+        square = core::MeshBuffers({{
+            .5f, .5f, .0f, // top right
+            .5f, -.5f, .0f, // bottom right
+            -.5f, -.5f, .0f, // bottom left
+            -.5f, .5f, .0f // top left
+        }, {
+            0, 1, 3, // first triangle
+            1, 2, 3 // second triangle
+        }});
+
+        core::ProgramHandle program = application.programs().acquire(basic_vertex, basic_fragment);
+        glUseProgram(program ? program->id() : 0);
+
+        #if 0
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        #endif
+        return program != nullptr;
     }
-    glfwMakeContextCurrent(window);
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    void build(core::FrameCommands &frame, std::uint64_t) override
     {
-        std::cout << "Failed to initialize GLAD" << std::endl;
-        glfwTerminate();
-        return EXIT_FAILURE;
+        frame.clearColor = {.2f, .3f, .3f, 1.0f};
+        frame.draws = {square.draw()};
+        frame.draws.back().label = "square";
     }
 
-    glfwSetFramebufferSizeCallback(window, onFrameBufferSizeCallback);
-    glfwSetKeyCallback(window, onKeyCallback);
-
-    float vertices[] = {
-        .5f, .5f, .0f, // top right
-        .5f, -.5f, .0f, // bottom right
-        -.5f, -.5f, .0f, // bottom left
-        -.5f, .5f, .0f // top left
-    };
-
-    unsigned int indices[] = {
-        0, 1, 3, // first triangle
-        1, 2, 3 // second triangle
-    };
-
-    std::function<void(int)> verifyShaderCompilationStatus = [](unsigned int id)
-    {
-        int status;
-        glGetShaderiv(id, GL_COMPILE_STATUS, &status);
-        if (!status)
-        {
-            char infoLog[512] = { 0 };
-            glGetShaderInfoLog(id, sizeof(infoLog), nullptr, infoLog);
-            std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED" << infoLog << std::endl;
-        }
-    };
-
-    unsigned int vertexShaderId;
-    vertexShaderId = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShaderId, 1, &basic_vertex, nullptr);
-    glCompileShader(vertexShaderId);
-    verifyShaderCompilationStatus(vertexShaderId);
-
-    unsigned int fragmentShaderId;
-    fragmentShaderId = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShaderId, 1, &basic_fragment, nullptr);
-    glCompileShader(fragmentShaderId);
-    verifyShaderCompilationStatus(fragmentShaderId);
+private:
+    core::MeshBuffers square;
+};
 
-    unsigned int shaderProgramId;
-    shaderProgramId = glCreateProgram();
-    glAttachShader(shaderProgramId, vertexShaderId);
-    glAttachShader(shaderProgramId, fragmentShaderId);
-    glLinkProgram(shaderProgramId);
-    glUseProgram(shaderProgramId);
-
-    glDeleteShader(vertexShaderId);
-    glDeleteShader(fragmentShaderId);
-
-    unsigned int vertexArrayObjectId;
-    glGenVertexArrays(1, &vertexArrayObjectId);
-    glBindVertexArray(vertexArrayObjectId);
-
-    unsigned int arrayBufferObjectId;
-    glGenBuffers(1, &arrayBufferObjectId);
-    glBindBuffer(GL_ARRAY_BUFFER, arrayBufferObjectId);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    unsigned int elementArrayBufferObjectId;
-    glGenBuffers(1, &elementArrayBufferObjectId);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, elementArrayBufferObjectId);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-
-    #if 0
-    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-    #endif
-
-    while (!glfwWindowShouldClose(window))
-    {
-        glClearColor(.2f, .3f, .3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
-
-        glDrawElements(GL_TRIANGLES, sizeof(indices) / sizeof(indices[0]), GL_UNSIGNED_INT, 0);
-
-        glfwPollEvents();
-        glfwSwapBuffers(window);
-    }
-
-    glfwTerminate();
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+int main(int argc, char **argv)
+{
+    return core::runScene<SquareScene>(argc, argv);
+}
@@ -1,7 +1,21 @@
 #version 330 core
+#pragma permutation VERTEX_COLOR
+#pragma specialization SRGB_OUTPUT
+#include "common/colors.glsl"
 out vec4 FragColor;
+#ifdef VERTEX_COLOR
+in vec4 vertexColor;
+#endif
 
 void main()
 {
-    FragColor = vec4(1.0f, 0.5f, 0.2f, 1.0f);
-}
\ No newline at end of file
+#ifdef VERTEX_COLOR
+    FragColor = vertexColor;
+#else
+    FragColor = DEFAULT_COLOR;
+#endif
+    if (SRGB_OUTPUT)
+    {
+        FragColor.rgb = pow(FragColor.rgb, vec3(1.0 / 2.2));
+    }
+}
@@ -1,7 +1,23 @@
 #version 330 core
+#pragma permutation VERTEX_COLOR TRANSFORM
 layout (location = 0) in vec3 aPos;
+#ifdef TRANSFORM
+#include "common/transform.glsl"
+#endif
+#ifdef VERTEX_COLOR
+layout (location = 1) in vec4 aColor;
+
+out vec4 vertexColor;
+#endif
 
 void main()
 {
+#ifdef TRANSFORM
+    gl_Position = model * vec4(aPos, 1.0);
+#else
     gl_Position = vec4(aPos.x, aPos.y, aPos.z, 1.0);
-}
\ No newline at end of file
+#endif
+#ifdef VERTEX_COLOR
+    vertexColor = aColor;
+#endif
+}
@@ -0,0 +1 @@
+const vec4 DEFAULT_COLOR = vec4(1.0f, 0.5f, 0.2f, 1.0f);
@@ -0,0 +1,4 @@
+layout (std140) uniform Transform
+{
+    mat4 model;
+};
@@ -0,0 +1,36 @@
+#ifndef EMBEDDED_SHADER_HEADER
+#define EMBEDDED_SHADER_HEADER
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// A shader source baked into the binary by shader_embed, as `chunkCount`
+// pieces to be passed to glShaderSource in order; variants share the
+// pieces they have in common. `length` is the size of the whole text and
+// `hash` its 64-bit FNV-1a, computed at build time, so caches and
+// registries can key on it without touching the text.
+//
+// When the build found glslangValidator, `spirv` also holds the shader as a
+// SPIR-V module for GL 4.6 / ARB_gl_spirv. Features in `specialized` are
+// specialisation constants there (constant_id = feature bit index), so
+// variants that differ only in those share one module and `features` says
+// which values to specialise it with.
+//
+// `files` names the source strings the `#line` directives in the text
+// refer to, the shader's own file first.
+struct EmbeddedShader
+{
+    const std::string_view *chunks;
+    std::size_t chunkCount;
+    std::size_t length;
+    std::uint64_t hash;
+    const std::uint32_t *spirv = nullptr;
+    std::size_t spirvWords = 0;
+    std::uint32_t features = 0;
+    std::uint32_t specialized = 0;
+    const char *const *files = nullptr;
+    std::size_t fileCount = 0;
+};
+
+#endif
@@ -0,0 +1,9 @@
+#version 330 core
+// Stands in for every fragment shader in the overdraw view: each fragment
+// adds one to its pixel through additive blending.
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = vec4(1.0);
+}
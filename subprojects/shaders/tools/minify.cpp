@@ -0,0 +1,390 @@
+#include "minify.hpp"
+
+#include <cctype>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    enum class TokenType
+    {
+        Directive,
+        Identifier,
+        Number,
+        Operator
+    };
+
+    struct Token
+    {
+        TokenType type;
+        std::string text;
+    };
+
+    const std::set<std::string> BuiltinTypes = {
+        "bool", "int", "uint", "float", "double",
+        "vec2", "vec3", "vec4", "ivec2", "ivec3", "ivec4",
+        "uvec2", "uvec3", "uvec4", "bvec2", "bvec3", "bvec4",
+        "dvec2", "dvec3", "dvec4",
+        "mat2", "mat3", "mat4", "mat2x2", "mat2x3", "mat2x4",
+        "mat3x2", "mat3x3", "mat3x4", "mat4x2", "mat4x3", "mat4x4"};
+
+    const std::set<std::string> Keywords = {
+        "do", "if", "in", "for", "out", "int", "uint", "bool", "true", "false",
+        "const", "inout", "while", "break", "return", "discard", "continue",
+        "flat", "smooth", "layout", "uniform", "struct", "void", "highp",
+        "lowp", "mediump", "precision", "invariant", "centroid", "sample",
+        "patch", "buffer", "shared", "switch", "case", "default", "else"};
+
+    const std::set<std::string> JoiningPairs = {
+        "++", "--", "+=", "-=", "*=", "/=", "==", "!=", "<=", ">=", "&&", "||",
+        "^^", "<<", ">>", "%=", "&=", "|=", "^=", "//", "/*", "*/"};
+
+    bool isIdentifierStart(char character)
+    {
+        return std::isalpha(static_cast<unsigned char>(character)) || character == '_';
+    }
+
+    bool isIdentifierChar(char character)
+    {
+        return std::isalnum(static_cast<unsigned char>(character)) || character == '_';
+    }
+
+    // Removes comments and collapses whitespace inside one directive.
+    std::string compactDirective(const std::string &directive)
+    {
+        std::string out;
+        bool pendingSpace = false;
+        for (std::size_t position = 0; position < directive.size(); position++)
+        {
+            const char character = directive[position];
+            if (character == '/' && position + 1 < directive.size() && directive[position + 1] == '/')
+            {
+                break;
+            }
+            if (character == '/' && position + 1 < directive.size() && directive[position + 1] == '*')
+            {
+                const std::size_t end = directive.find("*/", position + 2);
+                position = end == std::string::npos ? directive.size() : end + 1;
+                pendingSpace = true;
+                continue;
+            }
+            if (std::isspace(static_cast<unsigned char>(character)))
+            {
+                pendingSpace = true;
+                continue;
+            }
+            if (pendingSpace && !out.empty() && out != "#")
+            {
+                out += ' ';
+            }
+            pendingSpace = false;
+            out += character;
+        }
+        return out;
+    }
+
+    std::vector<Token> tokenize(const std::string &source)
+    {
+        std::vector<Token> tokens;
+        bool lineStart = true;
+        std::size_t position = 0;
+
+        while (position < source.size())
+        {
+            const char character = source[position];
+            const char next = position + 1 < source.size() ? source[position + 1] : '\0';
+
+            if (character == '\n')
+            {
+                lineStart = true;
+                position++;
+            }
+            else if (std::isspace(static_cast<unsigned char>(character)))
+            {
+                position++;
+            }
+            else if (character == '/' && next == '/')
+            {
+                position = source.find('\n', position);
+                position = position == std::string::npos ? source.size() : position;
+            }
+            else if (character == '/' && next == '*')
+            {
+                const std::size_t end = source.find("*/", position + 2);
+                position = end == std::string::npos ? source.size() : end + 2;
+            }
+            else if (character == '#' && lineStart)
+            {
+                std::string directive;
+                while (position < source.size() && source[position] != '\n')
+                {
+                    if (source[position] == '\\' && position + 1 < source.size() && source[position + 1] == '\n')
+                    {
+                        position += 2;
+                        continue;
+                    }
+                    directive += source[position++];
+                }
+                tokens.push_back({TokenType::Directive, compactDirective(directive)});
+            }
+            else if (isIdentifierStart(character))
+            {
+                const std::size_t begin = position;
+                while (position < source.size() && isIdentifierChar(source[position]))
+                {
+                    position++;
+                }
+                tokens.push_back({TokenType::Identifier, source.substr(begin, position - begin)});
+                lineStart = false;
+            }
+            else if (std::isdigit(static_cast<unsigned char>(character)) || (character == '.' && std::isdigit(static_cast<unsigned char>(next))))
+            {
+                const std::size_t begin = position;
+                while (position < source.size())
+                {
+                    const char current = source[position];
+                    const char previous = source[position - 1];
+                    if (isIdentifierChar(current) || current == '.' ||
+                        ((current == '+' || current == '-') && (previous == 'e' || previous == 'E') && position > begin))
+                    {
+                        position++;
+                        continue;
+                    }
+                    break;
+                }
+                tokens.push_back({TokenType::Number, source.substr(begin, position - begin)});
+                lineStart = false;
+            }
+            else
+            {
+                static const char *const Operators[] = {
+                    "<<=", ">>=", "++", "--", "+=", "-=", "*=", "/=", "==", "!=", "<=", ">=",
+                    "&&", "||", "^^", "<<", ">>", "%=", "&=", "|=", "^="};
+                std::string text(1, character);
+                for (const char *candidate : Operators)
+                {
+                    if (source.compare(position, std::char_traits<char>::length(candidate), candidate) == 0)
+                    {
+                        text = candidate;
+                        break;
+                    }
+                }
+                position += text.size();
+                tokens.push_back({TokenType::Operator, text});
+                lineStart = false;
+            }
+        }
+        return tokens;
+    }
+
+    std::string shortName(std::size_t index)
+    {
+        static const char Alphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        const std::size_t base = sizeof(Alphabet) - 1;
+        std::string name;
+        do
+        {
+            name.insert(name.begin(), Alphabet[index % base]);
+            index /= base;
+        } while (index-- > 0);
+        return name;
+    }
+
+    // Renames variables declared directly in function bodies (including
+    // nested blocks); declarations inside parentheses, such as for-loop
+    // initialisers, are left alone.
+    void renameLocals(std::vector<Token> &tokens)
+    {
+        std::set<std::string> taken;
+        std::set<std::string> reserved;
+        for (const Token &token : tokens)
+        {
+            if (token.type == TokenType::Identifier)
+            {
+                taken.insert(token.text);
+            }
+            else if (token.type == TokenType::Directive)
+            {
+                // Anything a macro may mention keeps its name.
+                std::string identifier;
+                for (char character : token.text + ' ')
+                {
+                    if (isIdentifierChar(character))
+                    {
+                        identifier += character;
+                    }
+                    else if (!identifier.empty())
+                    {
+                        reserved.insert(identifier);
+                        identifier.clear();
+                    }
+                }
+            }
+        }
+
+        std::vector<std::vector<std::pair<std::string, std::string>>> scopes;
+        std::size_t nextName = 0;
+        std::size_t depth = 0;
+        std::size_t parentheses = 0;
+        bool inFunction = false;
+        bool declaring = false;
+        std::string previous;
+
+        auto lookup = [&](const std::string &name) -> const std::string *
+        {
+            for (auto scope = scopes.rbegin(); scope != scopes.rend(); scope++)
+            {
+                for (auto entry = scope->rbegin(); entry != scope->rend(); entry++)
+                {
+                    if (entry->first == name)
+                    {
+                        return &entry->second;
+                    }
+                }
+            }
+            return nullptr;
+        };
+
+        auto declare = [&](Token &token)
+        {
+            if (reserved.count(token.text) || token.text.rfind("gl_", 0) == 0)
+            {
+                return;
+            }
+            std::string name;
+            do
+            {
+                name = shortName(nextName++);
+            } while (taken.count(name) || Keywords.count(name) || BuiltinTypes.count(name));
+            scopes.back().emplace_back(token.text, name);
+            token.text = name;
+        };
+
+        for (std::size_t token_n = 0; token_n < tokens.size(); token_n++)
+        {
+            Token &token = tokens[token_n];
+            const Token *following = token_n + 1 < tokens.size() ? &tokens[token_n + 1] : nullptr;
+
+            if (token.type == TokenType::Directive)
+            {
+                continue;
+            }
+
+            if (token.text == "{")
+            {
+                if (depth == 0 && previous == ")")
+                {
+                    inFunction = true;
+                    nextName = 0;
+                }
+                depth++;
+                if (inFunction)
+                {
+                    scopes.emplace_back();
+                }
+            }
+            else if (token.text == "}")
+            {
+                if (inFunction)
+                {
+                    scopes.pop_back();
+                }
+                depth--;
+                if (depth == 0)
+                {
+                    inFunction = false;
+                }
+            }
+            else if (token.text == "(")
+            {
+                parentheses++;
+            }
+            else if (token.text == ")")
+            {
+                parentheses--;
+            }
+            else if (token.text == ";")
+            {
+                declaring = false;
+            }
+            else if (inFunction && parentheses == 0 && token.type == TokenType::Identifier)
+            {
+                const bool declaresName =
+                    following && following->type == TokenType::Identifier &&
+                    BuiltinTypes.count(token.text) && previous != ".";
+                if (declaresName && !(token_n + 2 < tokens.size() && tokens[token_n + 2].text == "("))
+                {
+                    declaring = true;
+                    token_n++;
+                    declare(tokens[token_n]);
+                    previous = tokens[token_n].text;
+                    continue;
+                }
+                if (declaring && previous == ",")
+                {
+                    declare(token);
+                }
+                else if (previous != ".")
+                {
+                    if (const std::string *renamed = lookup(token.text))
+                    {
+                        token.text = *renamed;
+                    }
+                }
+            }
+            else if (inFunction && token.type == TokenType::Identifier && previous != ".")
+            {
+                if (const std::string *renamed = lookup(token.text))
+                {
+                    token.text = *renamed;
+                }
+            }
+
+            previous = token.text;
+        }
+    }
+
+    std::string join(const std::vector<Token> &tokens)
+    {
+        std::string out;
+        for (const Token &token : tokens)
+        {
+            if (token.type == TokenType::Directive)
+            {
+                if (!out.empty() && out.back() != '\n')
+                {
+                    out += '\n';
+                }
+                out += token.text;
+                out += '\n';
+                continue;
+            }
+            if (!out.empty() && out.back() != '\n')
+            {
+                const char last = out.back();
+                const char first = token.text.front();
+                const bool words = isIdentifierChar(last) && isIdentifierChar(first);
+                const bool joins = JoiningPairs.count(std::string{last, first}) > 0;
+                if (words || joins)
+                {
+                    out += ' ';
+                }
+            }
+            out += token.text;
+        }
+        if (!out.empty() && out.back() != '\n')
+        {
+            out += '\n';
+        }
+        return out;
+    }
+}
+
+std::string minifyGlsl(const std::string &source)
+{
+    std::vector<Token> tokens = tokenize(source);
+    renameLocals(tokens);
+    return join(tokens);
+}
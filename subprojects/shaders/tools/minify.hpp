@@ -0,0 +1,13 @@
+#ifndef SHADER_EMBED_MINIFY_HEADER
+#define SHADER_EMBED_MINIFY_HEADER
+
+#include <string>
+
+// Shrinks preprocessed GLSL without changing what it compiles to: comments
+// and redundant whitespace go away, preprocessor directives keep their own
+// lines, and variables declared inside function bodies get short names.
+// Globals (inputs, outputs, uniforms, functions, struct members) keep their
+// names since the application and the linker refer to them.
+std::string minifyGlsl(const std::string &source);
+
+#endif
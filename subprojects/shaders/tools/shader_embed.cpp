@@ -0,0 +1,1058 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "minify.hpp"
+#include "std140.hpp"
+
+// Preprocesses a GLSL file and turns it into a C++ header holding its bytes.
+//
+//     shader_embed <input.glsl> <output.hpp> <symbol> --bindings <table>
+//                  [-I <dir>]... [--depfile <file> <target>] [--minify]
+//                  [--spirv <glslangValidator> <vert|frag> <work dir>]
+//     shader_embed --block-table <table> <input.glsl>...
+//                  [-I <dir>]... [--depfile <file> <target>]
+//
+// Before embedding, `#include "file"` is resolved (relative to the including
+// file, then to each -I directory), and every `#pragma permutation NAME...`
+// adds a feature bit. One variant is emitted per feature combination, with
+// conditionals on the features (#ifdef, #ifndef, #if defined, #else, #endif)
+// already evaluated so no dead branch reaches the driver; enabled features
+// are also #defined after #version. `#pragma specialization NAME...` adds
+// features meant to be tested with a plain `if (NAME)`: the line becomes a
+// `const bool` per feature, or a specialisation constant in SPIR-V. With
+// --minify every variant is also stripped down by minifyGlsl() and the size
+// change is printed.
+//
+// Variants are stored as chunks split at their #line directives, so an
+// included file or a stretch no feature touches is embedded once however
+// many variants contain it. Minified variants are split the same way, then
+// the directives are dropped from the chunks. The text and header size this
+// saves is printed per shader, and a minified shader whose variants stop
+// sharing chunks the unminified ones share fails the build.
+//
+// Unless minified, variants carry `#line <n> <file id>` wherever the text
+// stops following its source (included files, dropped branches, inserted
+// lines), so driver messages point at the .glsl being edited; the ids index
+// <symbol>_files, which the loader uses to name the files in its log.
+//
+// Uniform block binding points are project-wide: --block-table reads every
+// shader once and writes a table with a point per block name, which each
+// shader's run then takes with --bindings. Points given in the source
+// (`layout(std140, binding = N)`) are kept, the other names get the lowest
+// free ones in name order. The table fails to build when a name is
+// declared with different members or points, or two names claim one point.
+//
+// With --spirv, every combination of the permutation features is also
+// compiled to a SPIR-V module for OpenGL. Inputs and outputs get locations
+// in declaration order and std140 blocks the binding of their generated
+// struct, since SPIR-V cannot match either by name. The header exposes
+//
+//     <symbol>_variants[mask]    an EmbeddedShader per feature bitmask
+//     <symbol>_feature::NAME     the bit of each feature
+//     <symbol>                   the variant with no feature enabled
+//     uniforms::<Block>          a std140 struct per `layout(std140) uniform`
+//
+// The text is emitted as byte arrays rather than string literals so large
+// shaders do not run into compiler limits on literal length, together with
+// its length and 64-bit FNV-1a hash. The output is only rewritten when its
+// content changes, which keeps the timestamps of untouched headers (and
+// everything including them) stable.
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    constexpr std::size_t MaxFeatures = 8;
+
+    struct Options
+    {
+        fs::path input;
+        std::vector<fs::path> inputs;
+        fs::path blockTable;
+        fs::path bindings;
+        fs::path output;
+        std::string symbol;
+        std::vector<fs::path> includeDirectories;
+        fs::path depfile;
+        std::string depfileTarget;
+        bool minify = false;
+        fs::path spirvCompiler;
+        std::string spirvStage;
+        fs::path spirvDirectory;
+    };
+
+    // Where a line came from: an index into Shader::files and a 1-based
+    // line number.
+    struct Location
+    {
+        std::size_t file;
+        std::size_t line;
+    };
+
+    struct Shader
+    {
+        std::vector<std::string> lines;
+        std::vector<Location> locations;
+        // Relative to the input's directory where possible; the input is 0.
+        std::vector<std::string> files;
+        std::vector<std::string> features;
+        // Bits of the features declared by #pragma specialization.
+        unsigned int specialized = 0;
+        std::set<fs::path> dependencies;
+    };
+
+    bool readFile(const fs::path &path, std::string &content)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    // Writes only when the content differs from what is already there.
+    bool updateFile(const fs::path &path, const std::string &content)
+    {
+        std::string existing;
+        if (readFile(path, existing) && existing == content)
+        {
+            return true;
+        }
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << content;
+        return static_cast<bool>(file);
+    }
+
+    std::uint64_t fnv1a64(const std::string &text)
+    {
+        std::uint64_t hash = 1469598103934665603ull;
+        for (char character : text)
+        {
+            hash = (hash ^ static_cast<unsigned char>(character)) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    std::string trim(const std::string &text)
+    {
+        const std::size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos)
+        {
+            return "";
+        }
+        const std::size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    // Splits "#  name rest" into ("name", "rest"); empty when not a directive.
+    bool parseDirective(const std::string &line, std::string &name, std::string &rest)
+    {
+        std::string text = trim(line);
+        if (text.empty() || text[0] != '#')
+        {
+            return false;
+        }
+        text = trim(text.substr(1));
+        const std::size_t split = text.find_first_of(" \t(");
+        name = text.substr(0, split);
+        rest = split == std::string::npos ? "" : trim(text.substr(split));
+        return true;
+    }
+
+    bool load(const Options &options, const fs::path &path, Shader &shader, std::vector<fs::path> &stack)
+    {
+        const fs::path canonical = fs::weakly_canonical(path);
+        for (const fs::path &active : stack)
+        {
+            if (active == canonical)
+            {
+                std::cerr << "shader_embed: recursive #include of " << path << std::endl;
+                return false;
+            }
+        }
+
+        std::string content;
+        if (!readFile(canonical, content))
+        {
+            std::cerr << "shader_embed: cannot read " << path << std::endl;
+            return false;
+        }
+        shader.dependencies.insert(canonical);
+        stack.push_back(canonical);
+
+        std::string shown = canonical.lexically_relative(fs::weakly_canonical(options.input).parent_path()).generic_string();
+        if (shown.empty() || shown.rfind("..", 0) == 0)
+        {
+            shown = canonical.generic_string();
+        }
+        std::size_t file = 0;
+        while (file < shader.files.size() && shader.files[file] != shown)
+        {
+            file++;
+        }
+        if (file == shader.files.size())
+        {
+            shader.files.push_back(shown);
+        }
+
+        std::istringstream stream(content);
+        std::string line;
+        std::size_t lineNumber = 0;
+        while (std::getline(stream, line))
+        {
+            lineNumber++;
+            std::string name;
+            std::string rest;
+            if (parseDirective(line, name, rest) && name == "include")
+            {
+                const std::size_t open = rest.find('"');
+                const std::size_t close = rest.find('"', open + 1);
+                if (open == std::string::npos || close == std::string::npos)
+                {
+                    std::cerr << "shader_embed: " << path << ": malformed #include" << std::endl;
+                    return false;
+                }
+                const fs::path target = rest.substr(open + 1, close - open - 1);
+
+                std::vector<fs::path> candidates = {canonical.parent_path() / target};
+                for (const fs::path &directory : options.includeDirectories)
+                {
+                    candidates.push_back(directory / target);
+                }
+
+                bool found = false;
+                for (const fs::path &candidate : candidates)
+                {
+                    if (fs::exists(candidate))
+                    {
+                        if (!load(options, candidate, shader, stack))
+                        {
+                            return false;
+                        }
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found)
+                {
+                    std::cerr << "shader_embed: " << path << ": cannot find include " << target << std::endl;
+                    return false;
+                }
+                continue;
+            }
+
+            if (parseDirective(line, name, rest) && name == "pragma" && rest.rfind("permutation", 0) == 0)
+            {
+                std::istringstream features(rest.substr(std::string("permutation").size()));
+                std::string feature;
+                while (features >> feature)
+                {
+                    shader.features.push_back(feature);
+                }
+                continue;
+            }
+
+            if (parseDirective(line, name, rest) && name == "pragma" && rest.rfind("specialization", 0) == 0)
+            {
+                std::istringstream features(rest.substr(std::string("specialization").size()));
+                std::string feature;
+                while (features >> feature)
+                {
+                    shader.specialized |= 1u << shader.features.size();
+                    shader.features.push_back(feature);
+                }
+                // Kept in place; expand() turns it into declarations.
+                shader.lines.push_back(line);
+                shader.locations.push_back({file, lineNumber});
+                continue;
+            }
+
+            shader.lines.push_back(line);
+            shader.locations.push_back({file, lineNumber});
+        }
+
+        stack.pop_back();
+        return true;
+    }
+
+    // Returns the feature index a conditional tests, or -1 when the
+    // condition is not about a feature (it is then passed through).
+    int conditionFeature(const Shader &shader, const std::string &name, const std::string &rest, bool &negated)
+    {
+        std::string symbol;
+        negated = false;
+        if (name == "ifdef" || name == "ifndef")
+        {
+            symbol = rest;
+            negated = name == "ifndef";
+        }
+        else if (name == "if")
+        {
+            std::string expression = rest;
+            if (!expression.empty() && expression[0] == '!')
+            {
+                negated = true;
+                expression = trim(expression.substr(1));
+            }
+            if (expression.rfind("defined", 0) != 0)
+            {
+                return -1;
+            }
+            expression = trim(expression.substr(std::string("defined").size()));
+            if (!expression.empty() && expression.front() == '(' && expression.back() == ')')
+            {
+                expression = trim(expression.substr(1, expression.size() - 2));
+            }
+            symbol = expression;
+        }
+        for (std::size_t feature_n = 0; feature_n < shader.features.size(); feature_n++)
+        {
+            if (shader.features[feature_n] == symbol)
+            {
+                return static_cast<int>(feature_n);
+            }
+        }
+        return -1;
+    }
+
+    // Gives a std140 block header line the binding its struct advertises.
+    std::string bindBlock(const std::string &line, const BlockBindings &blocks)
+    {
+        const std::size_t layout = line.find("std140");
+        const std::size_t uniform = layout == std::string::npos ? layout : line.find("uniform", layout);
+        if (uniform == std::string::npos || line.find("binding") < uniform)
+        {
+            return line;
+        }
+        std::istringstream rest(line.substr(uniform + std::string("uniform").size()));
+        std::string block;
+        rest >> block;
+        const auto binding = blocks.find(block.substr(0, block.find('{')));
+        if (binding == blocks.end())
+        {
+            return line;
+        }
+        const std::size_t end = layout + std::string("std140").size();
+        return line.substr(0, end) + ", binding = " + std::to_string(binding->second) + line.substr(end);
+    }
+
+    // Expands the variant for `mask`; for SPIR-V, specialization features
+    // become specialisation constants rather than fixed values. With
+    // `lineDirectives`, #line keeps messages pointing at the source.
+    bool expand(
+        const Shader &shader,
+        unsigned int mask,
+        bool spirv,
+        bool lineDirectives,
+        const BlockBindings &blocks,
+        std::string &variant)
+    {
+        struct Branch
+        {
+            bool evaluated;
+            bool parentActive;
+            bool taken;
+        };
+        std::vector<Branch> branches;
+        bool active = true;
+
+        // Where the compiler believes the next line of `variant` comes from.
+        // #line may not precede #version.
+        std::size_t compilerFile = 0;
+        std::size_t compilerLine = 1;
+        bool versionSeen = false;
+        auto emit = [&](const std::string &text, const Location &location)
+        {
+            if (lineDirectives && versionSeen && (compilerFile != location.file || compilerLine != location.line))
+            {
+                variant += "#line " + std::to_string(location.line) + " " + std::to_string(location.file) + "\n";
+                compilerFile = location.file;
+                compilerLine = location.line;
+            }
+            variant += text;
+            compilerLine += std::count(text.begin(), text.end(), '\n');
+        };
+
+        variant.clear();
+        for (std::size_t line_n = 0; line_n < shader.lines.size(); line_n++)
+        {
+            const std::string &line = shader.lines[line_n];
+            const Location &location = shader.locations[line_n];
+            std::string name;
+            std::string rest;
+            if (parseDirective(line, name, rest))
+            {
+                if (name == "ifdef" || name == "ifndef" || name == "if")
+                {
+                    bool negated;
+                    const int feature = conditionFeature(shader, name, rest, negated);
+                    if (feature >= 0 && ((shader.specialized >> feature) & 1))
+                    {
+                        std::cerr << "shader_embed: specialization feature " << shader.features[feature]
+                                  << " must be tested with if (), not the preprocessor" << std::endl;
+                        return false;
+                    }
+                    if (feature >= 0)
+                    {
+                        const bool taken = ((mask >> feature) & 1) != negated;
+                        branches.push_back({true, active, taken});
+                        active = active && taken;
+                        continue;
+                    }
+                    branches.push_back({false, active, true});
+                }
+                else if (name == "else" || name == "endif")
+                {
+                    if (branches.empty())
+                    {
+                        std::cerr << "shader_embed: unbalanced #" << name << std::endl;
+                        return false;
+                    }
+                    Branch &branch = branches.back();
+                    if (branch.evaluated)
+                    {
+                        if (name == "else")
+                        {
+                            branch.taken = !branch.taken;
+                            active = branch.parentActive && branch.taken;
+                        }
+                        else
+                        {
+                            active = branch.parentActive;
+                            branches.pop_back();
+                        }
+                        continue;
+                    }
+                    if (name == "endif")
+                    {
+                        branches.pop_back();
+                    }
+                }
+                else if (name == "elif" && !branches.empty() && branches.back().evaluated)
+                {
+                    std::cerr << "shader_embed: #elif on a permutation feature is not supported" << std::endl;
+                    return false;
+                }
+            }
+
+            if (!active)
+            {
+                continue;
+            }
+
+            if (parseDirective(line, name, rest) && name == "pragma" && rest.rfind("specialization", 0) == 0)
+            {
+                std::istringstream features(rest.substr(std::string("specialization").size()));
+                std::string feature;
+                std::string declarations;
+                while (features >> feature)
+                {
+                    std::size_t feature_n = 0;
+                    while (shader.features[feature_n] != feature)
+                    {
+                        feature_n++;
+                    }
+                    if (spirv)
+                    {
+                        declarations += "layout (constant_id = " + std::to_string(feature_n) + ") const bool " + feature + " = false;\n";
+                    }
+                    else
+                    {
+                        declarations += "const bool " + feature + ((mask >> feature_n) & 1 ? " = true;\n" : " = false;\n");
+                    }
+                }
+                emit(declarations, location);
+                continue;
+            }
+
+            emit((spirv ? bindBlock(line, blocks) : line) + '\n', location);
+
+            if (parseDirective(line, name, rest) && name == "version")
+            {
+                versionSeen = true;
+                std::string inserted;
+                if (spirv && !blocks.empty())
+                {
+                    // Block bindings in the source need 4.20 or this.
+                    inserted += "#extension GL_ARB_shading_language_420pack : require\n";
+                }
+                for (std::size_t feature_n = 0; feature_n < shader.features.size(); feature_n++)
+                {
+                    if (((mask & ~shader.specialized) >> feature_n) & 1)
+                    {
+                        inserted += "#define " + shader.features[feature_n] + " 1\n";
+                    }
+                }
+                variant += inserted;
+                compilerLine += std::count(inserted.begin(), inserted.end(), '\n');
+            }
+        }
+
+        if (!branches.empty())
+        {
+            std::cerr << "shader_embed: missing #endif" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void emitBytes(std::ostringstream &out, const std::string &name, const std::string &text)
+    {
+        out << "inline constexpr char " << name << "[] = {";
+        for (std::size_t byte_n = 0; byte_n <= text.size(); byte_n++)
+        {
+            if (byte_n % 16 == 0)
+            {
+                out << "\n   ";
+            }
+            const unsigned char byte = byte_n < text.size() ? text[byte_n] : 0;
+            char hex[16];
+            std::snprintf(hex, sizeof(hex), " '\\x%02x',", byte);
+            out << hex;
+        }
+        out << "\n};\n";
+    }
+
+    void emitWords(std::ostringstream &out, const std::string &name, const std::vector<std::uint32_t> &words)
+    {
+        out << "inline constexpr std::uint32_t " << name << "[] = {";
+        for (std::size_t word_n = 0; word_n < words.size(); word_n++)
+        {
+            if (word_n % 8 == 0)
+            {
+                out << "\n   ";
+            }
+            char hex[16];
+            std::snprintf(hex, sizeof(hex), " 0x%08xu,", static_cast<unsigned int>(words[word_n]));
+            out << hex;
+        }
+        out << "\n};\n";
+    }
+
+    bool compileSpirv(const Options &options, unsigned int mask, const std::string &text, std::vector<std::uint32_t> &words)
+    {
+        std::error_code error;
+        fs::create_directories(options.spirvDirectory, error);
+        const fs::path source = options.spirvDirectory / (options.symbol + "_" + std::to_string(mask) + "." + options.spirvStage);
+        const fs::path module = options.spirvDirectory / (options.symbol + "_" + std::to_string(mask) + ".spv");
+        if (!updateFile(source, text))
+        {
+            std::cerr << "shader_embed: cannot write " << source << std::endl;
+            return false;
+        }
+
+        const std::string command = "\"" + options.spirvCompiler.string() + "\" -G --aml -S " + options.spirvStage +
+                                    " -o \"" + module.string() + "\" \"" + source.string() + "\"";
+        std::string binary;
+        if (std::system(command.c_str()) != 0 || !readFile(module, binary) || binary.empty() || binary.size() % 4 != 0)
+        {
+            std::cerr << "shader_embed: SPIR-V compilation of " << source << " failed" << std::endl;
+            return false;
+        }
+        words.resize(binary.size() / 4);
+        std::memcpy(words.data(), binary.data(), binary.size());
+        return true;
+    }
+
+    // Each variant as indices into `chunks`, which holds every distinct
+    // piece once.
+    struct Chunks
+    {
+        std::vector<std::string> chunks;
+        std::vector<std::vector<std::size_t>> pieces;
+    };
+
+    // Splits every variant in front of each #line: a piece then starts
+    // where its source does, so it reads the same in any variant holding it.
+    // With `dropLineDirectives` the #line itself is left out of the piece.
+    Chunks shareChunks(const std::vector<std::string> &variants, bool dropLineDirectives)
+    {
+        Chunks shared;
+        for (const std::string &variant : variants)
+        {
+            std::vector<std::size_t> &pieces = shared.pieces.emplace_back();
+            std::size_t begin = 0;
+            while (begin < variant.size())
+            {
+                std::size_t end = variant.find("\n#line ", begin);
+                end = end == std::string::npos ? variant.size() : end + 1;
+                std::string chunk = variant.substr(begin, end - begin);
+                begin = end;
+                if (dropLineDirectives && chunk.compare(0, 6, "#line ") == 0)
+                {
+                    chunk.erase(0, chunk.find('\n') + 1);
+                }
+                if (chunk.empty())
+                {
+                    continue;
+                }
+                const auto found = std::find(shared.chunks.begin(), shared.chunks.end(), chunk);
+                pieces.push_back(found - shared.chunks.begin());
+                if (found == shared.chunks.end())
+                {
+                    shared.chunks.push_back(chunk);
+                }
+            }
+        }
+        return shared;
+    }
+
+    std::vector<std::string> minified(const std::vector<std::string> &variants)
+    {
+        std::vector<std::string> out;
+        for (const std::string &variant : variants)
+        {
+            out.push_back(minifyGlsl(variant));
+        }
+        return out;
+    }
+
+    // Pieces over all variants; more than the chunks when some are shared.
+    std::size_t pieceCount(const Chunks &shared)
+    {
+        std::size_t pieces = 0;
+        for (const std::vector<std::size_t> &variant : shared.pieces)
+        {
+            pieces += variant.size();
+        }
+        return pieces;
+    }
+
+    std::string generate(
+        const Shader &shader,
+        const std::vector<std::string> &variants,
+        const Chunks &shared,
+        const std::vector<std::vector<std::uint32_t>> &modules,
+        const std::string &symbol,
+        const std::string &structs)
+    {
+        std::ostringstream out;
+        out << "#ifndef " << symbol << "_HEADER\n";
+        out << "#define " << symbol << "_HEADER\n";
+        out << "#include <cstddef>\n";
+        out << "#include <cstdint>\n";
+        out << "#include <string_view>\n";
+        out << "#include <shaders/embedded.hpp>\n";
+        out << structs;
+
+        out << "struct " << symbol << "_feature\n{\n";
+        for (std::size_t feature_n = 0; feature_n < shader.features.size(); feature_n++)
+        {
+            out << "    static constexpr unsigned int " << shader.features[feature_n] << " = 1u << " << feature_n << ";\n";
+        }
+        out << "    static constexpr unsigned int count = " << variants.size() << ";\n";
+        out << "};\n";
+
+        out << "inline constexpr const char *" << symbol << "_files[] = {";
+        for (const std::string &file : shader.files)
+        {
+            out << "\n    \"" << file << "\",";
+        }
+        out << "\n};\n";
+
+        for (std::size_t chunk_n = 0; chunk_n < shared.chunks.size(); chunk_n++)
+        {
+            emitBytes(out, symbol + "_chunk_" + std::to_string(chunk_n), shared.chunks[chunk_n]);
+        }
+
+        // Variants a feature does not affect come out identical; their
+        // piece lists are stored once too.
+        std::vector<std::size_t> storage(variants.size());
+        for (std::size_t variant_n = 0; variant_n < variants.size(); variant_n++)
+        {
+            storage[variant_n] = variant_n;
+            for (std::size_t other_n = 0; other_n < variant_n; other_n++)
+            {
+                if (shared.pieces[other_n] == shared.pieces[variant_n])
+                {
+                    storage[variant_n] = storage[other_n];
+                    break;
+                }
+            }
+            if (storage[variant_n] == variant_n)
+            {
+                out << "inline constexpr std::string_view " << symbol << "_pieces_" << variant_n << "[] = {";
+                for (std::size_t chunk_n : shared.pieces[variant_n])
+                {
+                    out << "\n    {" << symbol << "_chunk_" << chunk_n << ", " << shared.chunks[chunk_n].size() << "},";
+                }
+                out << "\n};\n";
+            }
+        }
+
+        for (std::size_t module_n = 0; module_n < modules.size(); module_n++)
+        {
+            if (!modules[module_n].empty())
+            {
+                emitWords(out, symbol + "_spirv_" + std::to_string(module_n), modules[module_n]);
+            }
+        }
+
+        out << "inline constexpr EmbeddedShader " << symbol << "_variants[] = {\n";
+        for (std::size_t variant_n = 0; variant_n < variants.size(); variant_n++)
+        {
+            char hash[32];
+            std::snprintf(hash, sizeof(hash), "0x%016llxull", static_cast<unsigned long long>(fnv1a64(variants[variant_n])));
+            out << "    {" << symbol << "_pieces_" << storage[variant_n] << ", " << shared.pieces[variant_n].size() << ", "
+                << variants[variant_n].size() << ", " << hash << ", ";
+
+            // Variants differing only in specialisation constants share a module.
+            const std::size_t module_n = variant_n & ~shader.specialized;
+            if (modules[module_n].empty())
+            {
+                out << "nullptr, 0";
+            }
+            else
+            {
+                out << symbol << "_spirv_" << module_n << ", " << modules[module_n].size();
+            }
+            out << ", " << variant_n << "u, " << shader.specialized << "u, " << symbol << "_files, " << shader.files.size() << "},\n";
+        }
+        out << "};\n";
+        out << "inline constexpr const EmbeddedShader &" << symbol << " = " << symbol << "_variants[0];\n";
+        out << "#endif\n";
+        return out.str();
+    }
+
+    std::string depfile(const Options &options, const Shader &shader)
+    {
+        std::string out = options.depfileTarget + ":";
+        for (const fs::path &dependency : shader.dependencies)
+        {
+            std::string path = dependency.generic_string();
+            std::string escaped;
+            for (char character : path)
+            {
+                if (character == ' ')
+                {
+                    escaped += '\\';
+                }
+                escaped += character;
+            }
+            out += " \\\n  " + escaped;
+        }
+        return out + "\n";
+    }
+
+    // Collects the blocks of every input and writes `Name point` per line.
+    // `dependencies` receives every file read.
+    bool writeBlockTable(const Options &options, std::set<fs::path> &dependencies)
+    {
+        struct Declared
+        {
+            UniformBlock block;
+            fs::path input;
+        };
+        std::map<std::string, Declared> declared;
+        for (const fs::path &input : options.inputs)
+        {
+            Options shaderOptions = options;
+            shaderOptions.input = input;
+            Shader shader;
+            std::vector<fs::path> stack;
+            std::vector<UniformBlock> blocks;
+            std::string error;
+            if (!load(shaderOptions, input, shader, stack))
+            {
+                return false;
+            }
+            if (!std140Blocks(shader.lines, blocks, error))
+            {
+                std::cerr << "shader_embed: " << input << ": " << error << std::endl;
+                return false;
+            }
+            dependencies.insert(shader.dependencies.begin(), shader.dependencies.end());
+
+            for (const UniformBlock &block : blocks)
+            {
+                const auto [found, added] = declared.insert({block.name, {block, input}});
+                if (added)
+                {
+                    continue;
+                }
+                Declared &other = found->second;
+                if (other.block.layout != block.layout)
+                {
+                    std::cerr << "shader_embed: uniform block " << block.name << " is declared differently in " << other.input << " and "
+                              << input << std::endl;
+                    return false;
+                }
+                if (other.block.binding >= 0 && block.binding >= 0 && other.block.binding != block.binding)
+                {
+                    std::cerr << "shader_embed: uniform block " << block.name << " has binding " << other.block.binding << " in "
+                              << other.input << " but " << block.binding << " in " << input << std::endl;
+                    return false;
+                }
+                other.block.binding = std::max(other.block.binding, block.binding);
+            }
+        }
+
+        std::map<unsigned int, std::string> points;
+        for (const auto &[name, entry] : declared)
+        {
+            if (entry.block.binding < 0)
+            {
+                continue;
+            }
+            const auto [found, added] = points.insert({static_cast<unsigned int>(entry.block.binding), name});
+            if (!added)
+            {
+                std::cerr << "shader_embed: uniform blocks " << found->second << " and " << name << " both use binding "
+                          << entry.block.binding << std::endl;
+                return false;
+            }
+        }
+        unsigned int next = 0;
+        for (const auto &[name, entry] : declared)
+        {
+            if (entry.block.binding < 0)
+            {
+                while (points.count(next))
+                {
+                    next++;
+                }
+                points[next] = name;
+            }
+        }
+
+        std::string table;
+        for (const auto &[point, name] : points)
+        {
+            table += name + " " + std::to_string(point) + "\n";
+        }
+        if (!updateFile(options.blockTable, table))
+        {
+            std::cerr << "shader_embed: cannot write " << options.blockTable << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool readBlockTable(const fs::path &path, BlockBindings &bindings)
+    {
+        std::string content;
+        if (!readFile(path, content))
+        {
+            std::cerr << "shader_embed: cannot read " << path << std::endl;
+            return false;
+        }
+        std::istringstream stream(content);
+        std::string name;
+        unsigned int point;
+        while (stream >> name >> point)
+        {
+            bindings[name] = point;
+        }
+        return true;
+    }
+
+    bool parseOptions(int argc, char **argv, Options &options)
+    {
+        std::vector<std::string> positional;
+        for (int argument_n = 1; argument_n < argc; argument_n++)
+        {
+            const std::string argument = argv[argument_n];
+            if (argument == "-I" && argument_n + 1 < argc)
+            {
+                options.includeDirectories.emplace_back(argv[++argument_n]);
+            }
+            else if (argument == "--minify")
+            {
+                options.minify = true;
+            }
+            else if (argument == "--spirv" && argument_n + 3 < argc)
+            {
+                options.spirvCompiler = argv[++argument_n];
+                options.spirvStage = argv[++argument_n];
+                options.spirvDirectory = argv[++argument_n];
+            }
+            else if (argument == "--depfile" && argument_n + 2 < argc)
+            {
+                options.depfile = argv[++argument_n];
+                options.depfileTarget = argv[++argument_n];
+            }
+            else if (argument == "--block-table" && argument_n + 1 < argc)
+            {
+                options.blockTable = argv[++argument_n];
+            }
+            else if (argument == "--bindings" && argument_n + 1 < argc)
+            {
+                options.bindings = argv[++argument_n];
+            }
+            else
+            {
+                positional.push_back(argument);
+            }
+        }
+        if (!options.blockTable.empty())
+        {
+            options.inputs.assign(positional.begin(), positional.end());
+            return !options.inputs.empty();
+        }
+        if (positional.size() != 3 || options.bindings.empty())
+        {
+            return false;
+        }
+        options.input = positional[0];
+        options.output = positional[1];
+        options.symbol = positional[2];
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: shader_embed <input.glsl> <output.hpp> <symbol> --bindings <table> [-I <dir>]... [--depfile <file> <target>] [--minify] [--spirv <glslangValidator> <vert|frag> <work dir>]\n"
+                     "       shader_embed --block-table <table> <input.glsl>... [-I <dir>]... [--depfile <file> <target>]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    if (!options.blockTable.empty())
+    {
+        Shader all;
+        if (!writeBlockTable(options, all.dependencies))
+        {
+            return EXIT_FAILURE;
+        }
+        if (!options.depfile.empty() && !updateFile(options.depfile, depfile(options, all)))
+        {
+            std::cerr << "shader_embed: cannot write " << options.depfile << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    Shader shader;
+    std::vector<fs::path> stack;
+    if (!load(options, options.input, shader, stack))
+    {
+        return EXIT_FAILURE;
+    }
+    if (shader.features.size() > MaxFeatures)
+    {
+        std::cerr << "shader_embed: " << options.input << ": more than " << MaxFeatures << " permutation features" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    BlockBindings bindings;
+    if (!readBlockTable(options.bindings, bindings))
+    {
+        return EXIT_FAILURE;
+    }
+    std::string structs;
+    std::vector<std::string> names;
+    std::string error;
+    if (!std140Structs(shader.lines, bindings, structs, names, error))
+    {
+        std::cerr << "shader_embed: " << options.input << ": " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    BlockBindings blocks;
+    for (const std::string &name : names)
+    {
+        blocks[name] = bindings[name];
+    }
+
+    std::vector<std::string> variants(1u << shader.features.size());
+    for (unsigned int mask = 0; mask < variants.size(); mask++)
+    {
+        if (!expand(shader, mask, false, true, blocks, variants[mask]))
+        {
+            std::cerr << "shader_embed: in " << options.input << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::vector<std::vector<std::uint32_t>> modules(variants.size());
+    if (!options.spirvCompiler.empty())
+    {
+        for (unsigned int mask = 0; mask < variants.size(); mask++)
+        {
+            std::string text;
+            if ((mask & shader.specialized) == 0 &&
+                (!expand(shader, mask, true, true, blocks, text) || !compileSpirv(options, mask, text, modules[mask])))
+            {
+                std::cerr << "shader_embed: in " << options.input << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    // Minified with the #line directives still in: chunks split where they
+    // would unminified, and only lose the directives when stored.
+    const Chunks shared = shareChunks(options.minify ? minified(variants) : variants, options.minify);
+    if (options.minify)
+    {
+        const Chunks unminified = shareChunks(variants, false);
+        std::size_t before = 0;
+        std::size_t after = 0;
+        for (std::size_t variant_n = 0; variant_n < variants.size(); variant_n++)
+        {
+            const std::size_t original = variants[variant_n].size();
+            variants[variant_n].clear();
+            for (std::size_t piece : shared.pieces[variant_n])
+            {
+                variants[variant_n] += shared.chunks[piece];
+            }
+            before += original;
+            after += variants[variant_n].size();
+            std::cout << "shader_embed: " << options.symbol << "[" << variant_n << "]: "
+                      << original << " -> " << variants[variant_n].size() << " bytes" << std::endl;
+        }
+        std::cout << "shader_embed: " << options.symbol << ": " << before << " -> " << after << " bytes in "
+                  << variants.size() << " variants (" << (before ? 100 - after * 100 / before : 0) << "% smaller)" << std::endl;
+
+        if (shared.chunks.size() == pieceCount(shared) && unminified.chunks.size() < pieceCount(unminified))
+        {
+            std::cerr << "shader_embed: " << options.input << ": minified variants share no chunks, unminified ones share "
+                      << pieceCount(unminified) - unminified.chunks.size() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::size_t text = 0;
+    std::size_t stored = 0;
+    for (const std::string &variant : variants)
+    {
+        text += variant.size();
+    }
+    for (const std::string &chunk : shared.chunks)
+    {
+        stored += chunk.size();
+    }
+    // Every embedded byte costs a few characters of header for the C++
+    // compiler to get through, so the header shrinks with the text.
+    const std::string header = generate(shader, variants, shared, modules, options.symbol, structs);
+    std::cout << "shader_embed: " << options.symbol << ": " << variants.size() << " variants, " << text << " bytes of text stored as "
+              << stored << " in " << shared.chunks.size() << " shared chunks (" << (text ? 100 - stored * 100 / text : 0)
+              << "% smaller), " << header.size() / 1024 << " KiB header" << std::endl;
+
+    if (!updateFile(options.output, header))
+    {
+        std::cerr << "shader_embed: cannot write " << options.output << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (!options.depfile.empty() && !updateFile(options.depfile, depfile(options, shader)))
+    {
+        std::cerr << "shader_embed: cannot write " << options.depfile << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
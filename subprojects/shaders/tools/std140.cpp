@@ -0,0 +1,362 @@
+#include "std140.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Type
+    {
+        const char *scalar;
+        // Components per column and number of columns (1 unless a matrix).
+        unsigned int rows;
+        unsigned int columns;
+    };
+
+    const std::map<std::string, Type> Types = {
+        {"float", {"float", 1, 1}},
+        {"int", {"std::int32_t", 1, 1}},
+        {"uint", {"std::uint32_t", 1, 1}},
+        {"bool", {"std::uint32_t", 1, 1}},
+        {"vec2", {"float", 2, 1}},
+        {"vec3", {"float", 3, 1}},
+        {"vec4", {"float", 4, 1}},
+        {"ivec2", {"std::int32_t", 2, 1}},
+        {"ivec3", {"std::int32_t", 3, 1}},
+        {"ivec4", {"std::int32_t", 4, 1}},
+        {"uvec2", {"std::uint32_t", 2, 1}},
+        {"uvec3", {"std::uint32_t", 3, 1}},
+        {"uvec4", {"std::uint32_t", 4, 1}},
+        {"bvec2", {"std::uint32_t", 2, 1}},
+        {"bvec3", {"std::uint32_t", 3, 1}},
+        {"bvec4", {"std::uint32_t", 4, 1}},
+        {"mat2", {"float", 2, 2}},
+        {"mat3", {"float", 3, 3}},
+        {"mat4", {"float", 4, 4}},
+        {"mat2x2", {"float", 2, 2}},
+        {"mat2x3", {"float", 3, 2}},
+        {"mat2x4", {"float", 4, 2}},
+        {"mat3x2", {"float", 2, 3}},
+        {"mat3x3", {"float", 3, 3}},
+        {"mat3x4", {"float", 4, 3}},
+        {"mat4x2", {"float", 2, 4}},
+        {"mat4x3", {"float", 3, 4}},
+        {"mat4x4", {"float", 4, 4}}};
+
+    struct Member
+    {
+        Type type;
+        std::string name;
+        // 0 when not an array.
+        unsigned int count;
+    };
+
+    struct Block
+    {
+        std::string name;
+        std::vector<Member> members;
+        int binding = -1;
+    };
+
+    std::size_t alignUp(std::size_t value, std::size_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Identifiers, numbers and single punctuation characters, with comments
+    // and preprocessor lines left out.
+    std::vector<std::string> tokenize(const std::vector<std::string> &lines)
+    {
+        std::vector<std::string> tokens;
+        bool comment = false;
+        for (const std::string &line : lines)
+        {
+            const std::size_t first = line.find_first_not_of(" \t");
+            if (!comment && first != std::string::npos && line[first] == '#')
+            {
+                continue;
+            }
+            for (std::size_t position = 0; position < line.size();)
+            {
+                const char character = line[position];
+                if (comment)
+                {
+                    const std::size_t end = line.find("*/", position);
+                    comment = end == std::string::npos;
+                    position = comment ? line.size() : end + 2;
+                }
+                else if (line.compare(position, 2, "//") == 0)
+                {
+                    break;
+                }
+                else if (line.compare(position, 2, "/*") == 0)
+                {
+                    comment = true;
+                    position += 2;
+                }
+                else if (std::isalnum(static_cast<unsigned char>(character)) || character == '_')
+                {
+                    const std::size_t begin = position;
+                    while (position < line.size() && (std::isalnum(static_cast<unsigned char>(line[position])) || line[position] == '_'))
+                    {
+                        position++;
+                    }
+                    tokens.push_back(line.substr(begin, position - begin));
+                }
+                else
+                {
+                    if (!std::isspace(static_cast<unsigned char>(character)))
+                    {
+                        tokens.emplace_back(1, character);
+                    }
+                    position++;
+                }
+            }
+        }
+        return tokens;
+    }
+
+    bool parseBlock(const std::vector<std::string> &tokens, std::size_t &token_n, Block &block, std::string &error)
+    {
+        auto at = [&](std::size_t index) -> const std::string &
+        {
+            static const std::string End;
+            return index < tokens.size() ? tokens[index] : End;
+        };
+
+        block.name = at(token_n++);
+        if (at(token_n++) != "{")
+        {
+            error = "expected { after uniform block " + block.name;
+            return false;
+        }
+        while (at(token_n) != "}")
+        {
+            if (at(token_n).empty())
+            {
+                error = "unterminated uniform block " + block.name;
+                return false;
+            }
+            while (at(token_n) == "highp" || at(token_n) == "mediump" || at(token_n) == "lowp" || at(token_n) == "column_major")
+            {
+                token_n++;
+            }
+            const auto type = Types.find(at(token_n));
+            if (type == Types.end())
+            {
+                error = "uniform block " + block.name + ": unsupported member type " + at(token_n);
+                return false;
+            }
+            token_n++;
+            while (true)
+            {
+                Member member = {type->second, at(token_n++), 0};
+                if (at(token_n) == "[")
+                {
+                    const std::string &count = at(token_n + 1);
+                    if (count.empty() || !std::isdigit(static_cast<unsigned char>(count[0])) || at(token_n + 2) != "]")
+                    {
+                        error = "uniform block " + block.name + ": array " + member.name + " needs a literal size";
+                        return false;
+                    }
+                    member.count = static_cast<unsigned int>(std::stoul(count, nullptr, 0));
+                    token_n += 3;
+                }
+                block.members.push_back(member);
+                if (at(token_n) == ",")
+                {
+                    token_n++;
+                    continue;
+                }
+                if (at(token_n++) != ";")
+                {
+                    error = "uniform block " + block.name + ": expected ; after " + member.name;
+                    return false;
+                }
+                break;
+            }
+        }
+        token_n++;
+        return true;
+    }
+
+    // Offsets follow the std140 rules: scalars align to 4, two-component
+    // vectors to 8, three- and four-component vectors to 16; array elements
+    // and matrix columns are padded to 16 bytes each.
+    std::string emit(const Block &block, std::size_t binding)
+    {
+        std::ostringstream members;
+        std::ostringstream checks;
+        std::size_t offset = 0;
+        std::size_t padding_n = 0;
+
+        auto pad = [&](std::size_t to)
+        {
+            if (to > offset)
+            {
+                members << "    std::uint8_t padding" << padding_n++ << "[" << to - offset << "];\n";
+                offset = to;
+            }
+        };
+
+        for (const Member &member : block.members)
+        {
+            const Type &type = member.type;
+            const bool padded = member.count > 0 || type.columns > 1;
+            const std::size_t alignment = padded || type.rows > 2 ? 16 : type.rows * 4;
+            pad(alignUp(offset, alignment));
+
+            members << "    " << type.scalar << " " << member.name;
+            if (member.count > 0)
+            {
+                members << "[" << member.count << "]";
+            }
+            if (type.columns > 1)
+            {
+                members << "[" << type.columns << "]";
+            }
+            if (padded)
+            {
+                members << "[4]";
+            }
+            else if (type.rows > 1)
+            {
+                members << "[" << type.rows << "]";
+            }
+            members << ";\n";
+
+            checks << "static_assert(offsetof(" << block.name << ", " << member.name << ") == " << offset << ");\n";
+            offset += padded ? std::max(member.count, 1u) * type.columns * 16 : type.rows * 4;
+        }
+        pad(alignUp(offset, 16));
+
+        std::ostringstream out;
+        out << "namespace uniforms\n{\n";
+        out << "#ifndef UNIFORM_BLOCK_" << block.name << "_DEFINED\n";
+        out << "#define UNIFORM_BLOCK_" << block.name << "_DEFINED\n";
+        out << "struct alignas(16) " << block.name << "\n{\n";
+        out << "    static constexpr unsigned int binding = " << binding << ";\n";
+        out << members.str() << "};\n";
+        out << checks.str();
+        out << "#endif\n";
+        // Catches two shaders declaring the block differently.
+        out << "static_assert(sizeof(" << block.name << ") == " << offset << " && " << block.name << "::binding == " << binding
+            << ", \"uniform block " << block.name << " is declared differently across shaders\");\n";
+        out << "}\n";
+        return out.str();
+    }
+
+    bool parseBlocks(const std::vector<std::string> &lines, std::vector<Block> &blocks, std::string &error)
+    {
+        const std::vector<std::string> tokens = tokenize(lines);
+
+        for (std::size_t token_n = 0; token_n < tokens.size(); token_n++)
+        {
+            if (tokens[token_n] != "layout" || token_n + 1 >= tokens.size() || tokens[token_n + 1] != "(")
+            {
+                continue;
+            }
+
+            bool std140 = false;
+            bool rowMajor = false;
+            int binding = -1;
+            token_n += 2;
+            while (token_n < tokens.size() && tokens[token_n] != ")")
+            {
+                std140 = std140 || tokens[token_n] == "std140";
+                rowMajor = rowMajor || tokens[token_n] == "row_major";
+                if (tokens[token_n] == "binding" && token_n + 2 < tokens.size() && tokens[token_n + 1] == "=" &&
+                    std::isdigit(static_cast<unsigned char>(tokens[token_n + 2][0])))
+                {
+                    binding = static_cast<int>(std::stoul(tokens[token_n + 2], nullptr, 0));
+                }
+                token_n++;
+            }
+            if (!std140 || token_n + 2 >= tokens.size() || tokens[token_n + 1] != "uniform")
+            {
+                continue;
+            }
+            if (rowMajor)
+            {
+                error = "row_major uniform blocks are not supported";
+                return false;
+            }
+
+            token_n += 2;
+            Block block;
+            block.binding = binding;
+            if (!parseBlock(tokens, token_n, block, error))
+            {
+                return false;
+            }
+
+            // The same block may sit in several branches of a permutation.
+            bool seen = false;
+            for (const Block &other : blocks)
+            {
+                if (other.name == block.name)
+                {
+                    seen = true;
+                    if (emit(other, 0) != emit(block, 0) || other.binding != block.binding)
+                    {
+                        error = "uniform block " + block.name + " is declared twice with different members";
+                        return false;
+                    }
+                }
+            }
+            if (!seen)
+            {
+                blocks.push_back(block);
+            }
+        }
+        return true;
+    }
+}
+
+bool std140Structs(
+    const std::vector<std::string> &lines,
+    const BlockBindings &bindings,
+    std::string &structs,
+    std::vector<std::string> &names,
+    std::string &error)
+{
+    std::vector<Block> blocks;
+    if (!parseBlocks(lines, blocks, error))
+    {
+        return false;
+    }
+
+    structs.clear();
+    names.clear();
+    for (const Block &block : blocks)
+    {
+        const auto binding = bindings.find(block.name);
+        if (binding == bindings.end())
+        {
+            error = "uniform block " + block.name + " is not in the binding table";
+            return false;
+        }
+        structs += emit(block, binding->second);
+        names.push_back(block.name);
+    }
+    return true;
+}
+
+bool std140Blocks(const std::vector<std::string> &lines, std::vector<UniformBlock> &blocks, std::string &error)
+{
+    std::vector<Block> parsed;
+    if (!parseBlocks(lines, parsed, error))
+    {
+        return false;
+    }
+    blocks.clear();
+    for (const Block &block : parsed)
+    {
+        blocks.push_back({block.name, emit(block, 0), block.binding});
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef SHADER_EMBED_STD140_HEADER
+#define SHADER_EMBED_STD140_HEADER
+
+#include <map>
+#include <string>
+#include <vector>
+
+struct UniformBlock
+{
+    std::string name;
+    // The generated struct, for telling two declarations apart.
+    std::string layout;
+    // From `binding = N` in the declaration; -1 when not given.
+    int binding;
+};
+
+// Binding points by block name, assigned once for every shader in the
+// project (see shader_embed --block-table).
+using BlockBindings = std::map<std::string, unsigned int>;
+
+// Finds every `layout(std140) uniform Name { ... };` block in the shader
+// lines and writes a C++ struct per block into `structs`, laid out member
+// for member as std140 places it in the buffer, so a block can be filled
+// on the CPU and copied into a uniform buffer as is. Blocks that use
+// features the generator does not cover (nested structs, row_major, double
+// types, sized by a constant) make it fail with a message in `error`.
+//
+// Each block gets its point from `bindings`, exposed as <Block>::binding;
+// a block missing there is an error. `names` receives the block names in
+// declaration order.
+bool std140Structs(
+    const std::vector<std::string> &lines,
+    const BlockBindings &bindings,
+    std::string &structs,
+    std::vector<std::string> &names,
+    std::string &error);
+
+// Lists the blocks without generating anything, for building the table.
+bool std140Blocks(const std::vector<std::string> &lines, std::vector<UniformBlock> &blocks, std::string &error);
+
+#endif